@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench
+{
+	//sizes given on the command line replace the defaults
+	inline std::vector<int> GetSizes(int argc, char** argv, std::vector<int> someDefaults)
+	{
+		if (argc <= 1)
+		{
+			return someDefaults;
+		}
+
+		std::vector<int> sizes;
+		for (int i = 1; i < argc; ++i)
+		{
+			sizes.push_back(std::atoi(argv[i]));
+		}
+		return sizes;
+	}
+
+	//runs aFunc aRepeats times and reports the fastest run
+	template <typename Func>
+	double Measure(const std::string& aName, int aSize, int aRepeats, Func&& aFunc)
+	{
+		double best = 0;
+		for (int i = 0; i < aRepeats; ++i)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			aFunc();
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (i == 0 || ms < best)
+			{
+				best = ms;
+			}
+		}
+		std::printf("%-32s %10d %12.3f ms\n", aName.c_str(), aSize, best);
+		return best;
+	}
+
+	//one worker per core pulling indices, close to what the task graph does
+	inline void ThreadParallelFor(int aCount, const std::function<void(int)>& aBody)
+	{
+		std::atomic<int> next(0);
+		auto work = [&] {
+			for (int i = next++; i < aCount; i = next++)
+			{
+				aBody(i);
+			}
+		};
+		std::vector<std::thread> threads;
+		const int threadCount = std::min(aCount, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+		for (int i = 1; i < threadCount; ++i)
+		{
+			threads.emplace_back(work);
+		}
+		work();
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#include "Bench.h"
+#include "FabScene.h"
+#include <fstream>
+#include <iterator>
+
+static std::vector<std::uint8_t> ReadFile(const std::string& aPath)
+{
+	std::ifstream file(aPath, std::ios::binary);
+	return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static nlohmann::json Parse(const std::vector<std::uint8_t>& someBytes, metronome::FabFormat aFormat)
+{
+	switch (aFormat)
+	{
+	case metronome::FabFormat::MessagePack: return nlohmann::json::from_msgpack(someBytes);
+	case metronome::FabFormat::Cbor: return nlohmann::json::from_cbor(someBytes);
+	case metronome::FabFormat::Ubjson: return nlohmann::json::from_ubjson(someBytes);
+	case metronome::FabFormat::Bson: return nlohmann::json::from_bson(someBytes);
+	default: return nlohmann::json::parse(someBytes);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::pair<metronome::FabFormat, const char*> formats[] = {
+		{ metronome::FabFormat::Json, "json" },
+		{ metronome::FabFormat::MessagePack, "msgpack" },
+		{ metronome::FabFormat::Cbor, "cbor" },
+		{ metronome::FabFormat::Ubjson, "ubjson" },
+		{ metronome::FabFormat::Bson, "bson" },
+	};
+
+	for (int size : bench::GetSizes(argc, argv, { 10000, 100000 }))
+	{
+		const std::vector<BenchEntity> entities = MakeEntities(size);
+		const metronome::SceneSnapshot snapshot = MakeSceneSnapshot(entities);
+		const nlohmann::json scene = CreateSceneJson(entities);
+		const std::string text = scene.dump();
+
+		for (const auto& format : formats)
+		{
+			const std::string path = std::string("BenchFabBinary") + metronome::GetFabExtension(format.first);
+			bool succeeded = false;
+			bench::Measure(std::string("write ") + format.second, size, 1, [&] {
+				metronome::FabWriter writer(format.first);
+				if (writer.Open(path))
+				{
+					metronome::WriteScene(writer, snapshot);
+					succeeded = writer.Close();
+				}
+			});
+
+			const std::vector<std::uint8_t> bytes = ReadFile(path);
+			nlohmann::json parsed;
+			bench::Measure(std::string("parse ") + format.second, size, 3, [&] {
+				parsed = Parse(bytes, format.first);
+			});
+			std::printf("%-32s %10d %12zu bytes\n", (std::string(format.second) + " size").c_str(), size, bytes.size());
+
+			//the writer has to build the same tree the json path does, and the loader has to get it back
+			const std::vector<std::uint8_t> expected = format.first == metronome::FabFormat::Json
+				? std::vector<std::uint8_t>(text.begin(), text.end())
+				: metronome::EncodeBinaryJson(scene, format.first);
+			if (!succeeded || bytes != expected || parsed["root"]["components"].size() != 2)
+			{
+				std::printf("%s .fab doesn't match the json tree\n", format.second);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
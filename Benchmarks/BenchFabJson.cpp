@@ -0,0 +1,85 @@
+#include "Bench.h"
+#include "FabScene.h"
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+//compared block by block, the pretty million entity document doesn't fit in memory three times
+static bool FilesMatch(const std::string& aPathA, const std::string& aPathB, size_t& aSizeOut)
+{
+	std::ifstream fileA(aPathA, std::ios::binary);
+	std::ifstream fileB(aPathB, std::ios::binary);
+	std::vector<char> blockA(1 << 20);
+	std::vector<char> blockB(1 << 20);
+	aSizeOut = 0;
+	while (fileA && fileB)
+	{
+		fileA.read(blockA.data(), blockA.size());
+		fileB.read(blockB.data(), blockB.size());
+		if (fileA.gcount() != fileB.gcount() || !std::equal(blockA.begin(), blockA.begin() + fileA.gcount(), blockB.begin()))
+		{
+			return false;
+		}
+		aSizeOut += static_cast<size_t>(fileA.gcount());
+	}
+	return fileA.eof() && fileB.eof();
+}
+
+//the json tree of a million entities needs more than 6 GB, above this only the streaming writers run
+constexpr int maxDomSize = 100000;
+
+int main(int argc, char** argv)
+{
+	for (int size : bench::GetSizes(argc, argv, { 10000, 100000, 1000000 }))
+	{
+		const std::vector<BenchEntity> entities = MakeEntities(size);
+		const metronome::SceneSnapshot snapshot = MakeSceneSnapshot(entities);
+
+		for (bool shouldMakeCompact : { true, false })
+		{
+			const char* mode = shouldMakeCompact ? "compact" : "pretty";
+			const std::string domPath = std::string("BenchFabJsonDom_") + mode + ".fab";
+			const std::string streamPath = std::string("BenchFabJsonStream_") + mode + ".fab";
+
+			const bool shouldBuildDom = size <= maxDomSize;
+			if (shouldBuildDom)
+			{
+				bench::Measure(std::string("build + write json ") + mode, size, 1, [&] {
+					metronome::WriteJsonToFile(domPath, CreateSceneJson(entities), shouldMakeCompact);
+				});
+			}
+			bool succeeded = false;
+			bench::Measure(std::string("stream ") + mode, size, 1, [&] {
+				metronome::FabWriter writer(shouldMakeCompact);
+				if (writer.Open(streamPath))
+				{
+					metronome::WriteScene(writer, snapshot);
+					succeeded = writer.Close();
+				}
+			});
+
+			const std::string parallelPath = std::string("BenchFabJsonParallel_") + mode + ".fab";
+			bool parallelSucceeded = false;
+			bench::Measure(std::string("stream parallel ") + mode, size, 1, [&] {
+				metronome::FabWriter writer(shouldMakeCompact);
+				if (writer.Open(parallelPath))
+				{
+					metronome::WriteScene(writer, snapshot, bench::ThreadParallelFor);
+					parallelSucceeded = writer.Close();
+				}
+			});
+
+			//without the tree the serial stream is the reference, it matches the tree at every smaller size
+			const std::string& referencePath = shouldBuildDom ? domPath : streamPath;
+			size_t referenceSize = 0;
+			const bool matches = FilesMatch(referencePath, streamPath, referenceSize) && FilesMatch(referencePath, parallelPath, referenceSize);
+			std::printf("%-32s %10d %12zu bytes\n", (std::string(mode) + " size").c_str(), size, referenceSize);
+			if (!succeeded || !parallelSucceeded || !matches)
+			{
+				std::printf("streamed %s .fab differs from the json tree\n", mode);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,217 @@
+#include "Bench.h"
+#include "NavGrid.h"
+#include "ExportCore/NavBinary.h"
+#include "ExportCore/NavChunks.h"
+#include "ExportCore/NavTileSet.h"
+#include "ExportCore/ObjWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iterator>
+
+//the writer this replaced, kept as a baseline
+static void WriteObjIostream(const std::string& aPath, const metronome::NavMesh& aMesh)
+{
+	std::ofstream file(aPath);
+	for (const metronome::Vec3& vec : aMesh.myVertices)
+	{
+		const metronome::Vec3 newVec = metronome::ToExportVector(vec);
+		file << "v " << newVec.x << " " << newVec.y << " " << newVec.z << std::endl;
+	}
+	for (const metronome::Face& face : aMesh.myFaces)
+	{
+		file << "f " << face.x << " " << face.y << " " << face.z << std::endl;
+	}
+}
+
+static void AsyncParallelFor(int aCount, const std::function<void(int)>& aBody)
+{
+	std::vector<std::future<void>> tasks;
+	for (int i = 0; i < aCount; ++i)
+	{
+		tasks.push_back(std::async(std::launch::async, aBody, i));
+	}
+	for (std::future<void>& task : tasks)
+	{
+		task.get();
+	}
+}
+
+//writes a tile set with a params blob and tiles of dtNavMeshParams-like sizes, then reads it back in place
+static bool CheckNavTileSet(const std::string& aPath)
+{
+	std::vector<unsigned char> params(28);
+	for (size_t i = 0; i < params.size(); ++i)
+	{
+		params[i] = static_cast<unsigned char>(i + 1);
+	}
+	std::vector<std::vector<unsigned char>> tileData;
+	std::vector<metronome::NavTileBlob> blobs;
+	for (size_t size : { 12, 40, 4, 100 })
+	{
+		tileData.emplace_back(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			tileData.back()[i] = static_cast<unsigned char>(tileData.size() * 31 + i);
+		}
+	}
+	for (size_t i = 0; i < tileData.size(); ++i)
+	{
+		metronome::NavTileBlob blob;
+		blob.myTileRef = 0x100000000ull * (i + 1) + i;
+		blob.myData = tileData[i].data();
+		blob.mySize = tileData[i].size();
+		blobs.push_back(blob);
+	}
+	if (!metronome::WriteNavTileSet(aPath, params.data(), params.size(), blobs))
+	{
+		return false;
+	}
+
+	std::ifstream file(aPath, std::ios::binary);
+	const std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	metronome::NavTileSetHeader header;
+	if (data.size() < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (header.myMagic != metronome::navTileSetMagic || header.myVersion != metronome::navTileSetVersion
+		|| header.myTileCount != blobs.size() || header.myParamsSize != params.size()
+		|| std::memcmp(data.data() + sizeof(header), params.data(), params.size()) != 0)
+	{
+		return false;
+	}
+
+	size_t offset = sizeof(header) + metronome::AlignNavTileSetSize(header.myParamsSize);
+	for (const metronome::NavTileBlob& blob : blobs)
+	{
+		metronome::NavTileSetTile tile;
+		if (offset % metronome::navTileSetAlignment != 0 || offset + sizeof(tile) > data.size())
+		{
+			return false;
+		}
+		std::memcpy(&tile, data.data() + offset, sizeof(tile));
+		offset += sizeof(tile);
+		if (tile.myTileRef != blob.myTileRef || tile.mySize != blob.mySize || offset % metronome::navTileSetAlignment != 0
+			|| offset + tile.mySize > data.size() || std::memcmp(data.data() + offset, blob.myData, blob.mySize) != 0)
+		{
+			return false;
+		}
+		offset += metronome::AlignNavTileSetSize(tile.mySize);
+	}
+	return offset == data.size();
+}
+
+int main(int argc, char** argv)
+{
+	if (!CheckNavTileSet("BenchNavBinary.navtiles"))
+	{
+		std::printf("nav tile set doesn't round trip\n");
+		return 1;
+	}
+
+	const std::string objPath = "BenchNavBinary.obj";
+	const std::string binaryPath = "BenchNavBinary.mnav";
+
+	for (int size : bench::GetSizes(argc, argv, { 10000, 200000 }))
+	{
+		const metronome::NavMesh mesh = metronome::MergeTileMeshes(BuildTileMeshes(MakeGridTiles(size)), 0.0f);
+
+		bench::Measure("write obj iostream", size, 3, [&] {
+			WriteObjIostream(objPath, mesh);
+		});
+		bench::Measure("write obj", size, 3, [&] {
+			metronome::WriteObj(objPath, mesh);
+		});
+		bench::Measure("write obj parallel", size, 3, [&] {
+			metronome::WriteObj(objPath, mesh, {}, AsyncParallelFor);
+		});
+		metronome::ObjWriteSettings fixedSettings;
+		fixedSettings.myPrecision = 3;
+		bench::Measure("write obj fixed 3", size, 3, [&] {
+			metronome::WriteObj(objPath, mesh, fixedSettings);
+		});
+		bench::Measure("write mnav", size, 3, [&] {
+			metronome::NavBinaryWriter writer;
+			metronome::AddNavMeshSections(writer, mesh);
+			writer.Write(binaryPath);
+		});
+
+		std::vector<unsigned char> raw;
+		std::vector<unsigned char> compressed;
+		bench::Measure("build mnav compressed", size, 3, [&] {
+			metronome::NavBinaryWriter writer;
+			metronome::AddNavMeshSections(writer, mesh, true);
+			compressed = writer.Build();
+		});
+		{
+			metronome::NavBinaryWriter writer;
+			metronome::AddNavMeshSections(writer, mesh);
+			raw = writer.Build();
+		}
+		metronome::NavBinaryView rawView;
+		metronome::NavBinaryView compressedView;
+		std::vector<float> positions;
+		std::vector<std::uint32_t> indices;
+		bench::Measure("decode mnav compressed", size, 3, [&] {
+			compressedView.Init(compressed.data(), compressed.size());
+			positions = metronome::DecodeNavPositions(compressedView);
+			indices = metronome::DecodeNavIndices(compressedView);
+		});
+		rawView.Init(raw.data(), raw.size());
+		const std::vector<float> rawPositions = metronome::DecodeNavPositions(rawView);
+		float maxError = 0.0f;
+		for (size_t i = 0; i < rawPositions.size() && i < positions.size(); ++i)
+		{
+			maxError = std::max(maxError, std::abs(rawPositions[i] - positions[i]));
+		}
+		std::printf("mnav %zu bytes, compressed %zu bytes, max position error %f\n", raw.size(), compressed.size(), maxError);
+		if (positions.size() != rawPositions.size() || indices != metronome::DecodeNavIndices(rawView) || maxError > 0.1f)
+		{
+			std::printf("compressed mnav doesn't match\n");
+			return 1;
+		}
+
+		std::vector<metronome::NavChunk> chunks;
+		bench::Measure("split + write 2x2 chunks", size, 3, [&] {
+			chunks = metronome::SplitNavMesh(mesh, 2);
+			metronome::WriteNavChunks("BenchNavBinaryChunk", chunks, 2);
+		});
+		size_t chunkFaceCount = 0;
+		for (const metronome::NavChunk& chunk : chunks)
+		{
+			chunkFaceCount += chunk.myMesh.myFaces.size();
+			for (const metronome::NavStitch& stitch : chunk.myStitches)
+			{
+				if (chunk.myMesh.myVertices[stitch.myLocalVertex] != mesh.myVertices[stitch.myGlobalVertex])
+				{
+					std::printf("chunk stitch points at the wrong vertex\n");
+					return 1;
+				}
+			}
+		}
+		if (chunkFaceCount != mesh.myFaces.size())
+		{
+			std::printf("chunks lost triangles\n");
+			return 1;
+		}
+
+		bool isValid = false;
+		bench::Measure("load + validate mnav", size, 3, [&] {
+			std::ifstream file(binaryPath, std::ios::binary);
+			const std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			metronome::NavBinaryView view;
+			size_t indexSize = 0;
+			isValid = view.Init(data.data(), data.size()) && view.FindSection(metronome::NavSection::indices, &indexSize) != nullptr && indexSize > 0;
+		});
+		if (!isValid)
+		{
+			std::printf("mnav failed to validate\n");
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,207 @@
+#include "Bench.h"
+#include "NavGrid.h"
+#include "ExportCore/NavHierarchy.h"
+#include "ExportCore/NavIslands.h"
+#include "ExportCore/NavLandmarks.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+
+using QueueItem = std::pair<float, std::uint32_t>;
+using OpenList = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+//a* over every poly, plain dijkstra without a heuristic. reopens polys so an admissible heuristic is enough
+static float FindPolyPathCost(const metronome::NavGraph& aGraph, std::uint32_t aStart, std::uint32_t aGoal,
+	const std::function<float(std::uint32_t)>& aHeuristic = {}, int* anExpandedCount = nullptr)
+{
+	std::vector<float> costs(aGraph.myCentroids.size(), std::numeric_limits<float>::infinity());
+	using AStarItem = std::pair<float, std::pair<float, std::uint32_t>>;
+	std::priority_queue<AStarItem, std::vector<AStarItem>, std::greater<AStarItem>> open;
+	costs[aStart] = 0.0f;
+	open.push({ 0.0f, { 0.0f, aStart } });
+	while (!open.empty())
+	{
+		const float cost = open.top().second.first;
+		const std::uint32_t poly = open.top().second.second;
+		open.pop();
+		if (poly == aGoal)
+		{
+			return cost;
+		}
+		if (cost > costs[poly])
+		{
+			continue;
+		}
+		if (anExpandedCount)
+		{
+			++*anExpandedCount;
+		}
+		for (std::uint32_t link = aGraph.myLinkOffsets[poly]; link < aGraph.myLinkOffsets[poly + 1]; ++link)
+		{
+			const std::uint32_t target = aGraph.myLinks[link];
+			const float targetCost = cost + metronome::GetNavLinkCost(aGraph, poly, link);
+			if (targetCost < costs[target])
+			{
+				costs[target] = targetCost;
+				open.push({ targetCost + (aHeuristic ? aHeuristic(target) : 0.0f), { targetCost, target } });
+			}
+		}
+	}
+	return std::numeric_limits<float>::infinity();
+}
+
+static float FindNodePathCost(const metronome::NavClusterGraph& aClusterGraph, std::uint32_t aStart, std::uint32_t aGoal)
+{
+	std::vector<float> costs(aClusterGraph.myNodePolys.size(), std::numeric_limits<float>::infinity());
+	OpenList open;
+	costs[aStart] = 0.0f;
+	open.push({ 0.0f, aStart });
+	while (!open.empty())
+	{
+		const QueueItem item = open.top();
+		open.pop();
+		if (item.second == aGoal)
+		{
+			return item.first;
+		}
+		if (item.first > costs[item.second])
+		{
+			continue;
+		}
+		for (std::uint32_t edge = aClusterGraph.myEdgeOffsets[item.second]; edge < aClusterGraph.myEdgeOffsets[item.second + 1]; ++edge)
+		{
+			const metronome::NavClusterEdge& clusterEdge = aClusterGraph.myEdges[edge];
+			const float cost = item.first + clusterEdge.myCost;
+			if (cost < costs[clusterEdge.myTarget])
+			{
+				costs[clusterEdge.myTarget] = cost;
+				open.push({ cost, clusterEdge.myTarget });
+			}
+		}
+	}
+	return std::numeric_limits<float>::infinity();
+}
+
+int main(int argc, char** argv)
+{
+	for (int size : bench::GetSizes(argc, argv, { 10000, 200000 }))
+	{
+		const std::vector<metronome::NavTileGraph> tileGraphs = MakeGridTileGraphs(size);
+
+		metronome::NavGraph graph;
+		bench::Measure("merge tile graphs", size, 3, [&] {
+			graph = metronome::MergeTileGraphs(tileGraphs);
+		});
+		metronome::NavClusterGraph clusterGraph;
+		bench::Measure("build cluster graph", size, 3, [&] {
+			clusterGraph = metronome::BuildClusterGraph(graph);
+		});
+		std::printf("%d polys, %zu entrance nodes, %zu abstract edges\n", static_cast<int>(graph.myCentroids.size()), clusterGraph.myNodePolys.size(), clusterGraph.myEdges.size());
+
+		//the grid is one island. cutting the links out of the first tile leaves it reachable one way only
+		metronome::NavIslands islands;
+		bench::Measure("label islands", size, 3, [&] {
+			islands = metronome::BuildNavIslands(graph, {});
+		});
+		metronome::NavGraph oneWayGraph = graph;
+		const std::uint32_t cutPoly = graph.myFirstPolys[1];
+		for (std::uint32_t link = oneWayGraph.myLinkOffsets[0]; link < oneWayGraph.myLinkOffsets[cutPoly]; ++link)
+		{
+			if (oneWayGraph.myLinks[link] >= cutPoly)
+			{
+				oneWayGraph.myLinks[link] = 0;
+			}
+		}
+		const metronome::NavIslands oneWayIslands = metronome::BuildNavIslands(oneWayGraph, {});
+		if (*std::max_element(islands.myPolyIslands.begin(), islands.myPolyIslands.end()) != 0
+			|| *std::max_element(islands.myPolyComponents.begin(), islands.myPolyComponents.end()) != 0
+			|| *std::max_element(oneWayIslands.myPolyIslands.begin(), oneWayIslands.myPolyIslands.end()) != 0
+			|| oneWayIslands.myPolyComponents[0] == oneWayIslands.myPolyComponents[cutPoly]
+			|| oneWayIslands.myPolyComponents[0] != oneWayIslands.myPolyComponents[cutPoly - 1])
+		{
+			std::printf("island labels are wrong\n");
+			return 1;
+		}
+
+		//polys the one way links land on still have to be nodes of the abstract graph
+		const metronome::NavClusterGraph oneWayClusterGraph = metronome::BuildClusterGraph(oneWayGraph);
+		for (const metronome::NavClusterEdge& edge : oneWayClusterGraph.myEdges)
+		{
+			if (edge.myTarget >= oneWayClusterGraph.myNodePolys.size())
+			{
+				std::printf("abstract edge leads to a poly that is not a node\n");
+				return 1;
+			}
+		}
+
+		//paths between entrances over the abstract graph cost the same as over every poly
+		std::mt19937 random(1);
+		std::uniform_int_distribution<std::uint32_t> pickNode(0, static_cast<std::uint32_t>(clusterGraph.myNodePolys.size()) - 1);
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> queries;
+		for (int i = 0; i < 20; ++i)
+		{
+			queries.push_back({ pickNode(random), pickNode(random) });
+		}
+
+		std::vector<float> polyCosts;
+		bench::Measure("20 poly graph queries", size, 1, [&] {
+			for (const auto& query : queries)
+			{
+				polyCosts.push_back(FindPolyPathCost(graph, clusterGraph.myNodePolys[query.first], clusterGraph.myNodePolys[query.second]));
+			}
+		});
+		std::vector<float> nodeCosts;
+		bench::Measure("20 cluster graph queries", size, 1, [&] {
+			for (const auto& query : queries)
+			{
+				nodeCosts.push_back(FindNodePathCost(clusterGraph, query.first, query.second));
+			}
+		});
+		for (size_t i = 0; i < queries.size(); ++i)
+		{
+			if (std::abs(polyCosts[i] - nodeCosts[i]) > 1e-4f * std::max(polyCosts[i], 1.0f))
+			{
+				std::printf("cluster graph cost %f differs from poly graph cost %f\n", nodeCosts[i], polyCosts[i]);
+				return 1;
+			}
+		}
+
+		//the landmark bound never overestimates, so a* with it finds the same costs while expanding fewer polys
+		metronome::NavLandmarks landmarks;
+		bench::Measure("build 8 landmarks", size, 1, [&] {
+			landmarks = metronome::BuildNavLandmarks(graph, 8);
+		});
+		int dijkstraExpanded = 0;
+		int landmarkExpanded = 0;
+		for (size_t i = 0; i < queries.size(); ++i)
+		{
+			const std::uint32_t start = clusterGraph.myNodePolys[queries[i].first];
+			const std::uint32_t goal = clusterGraph.myNodePolys[queries[i].second];
+			FindPolyPathCost(graph, start, goal, {}, &dijkstraExpanded);
+			const float cost = FindPolyPathCost(graph, start, goal, [&](std::uint32_t aPoly) {
+				return metronome::GetNavLandmarkBound(landmarks, aPoly, goal);
+			}, &landmarkExpanded);
+			if (metronome::GetNavLandmarkBound(landmarks, start, goal) > polyCosts[i] || std::abs(cost - polyCosts[i]) > 1e-4f * std::max(polyCosts[i], 1.0f))
+			{
+				std::printf("landmark bound overestimates, a* cost %f differs from dijkstra cost %f\n", cost, polyCosts[i]);
+				return 1;
+			}
+		}
+		std::printf("20 queries expand %d polys with dijkstra, %d with landmarks\n", dijkstraExpanded, landmarkExpanded);
+
+		//the first tile of the one way grid can't reach the rest, a landmark inside it proves that
+		const metronome::NavLandmarks oneWayLandmarks = metronome::BuildNavLandmarks(oneWayGraph, 8);
+		const float backCost = FindPolyPathCost(oneWayGraph, cutPoly, 0);
+		if (!std::isinf(FindPolyPathCost(oneWayGraph, 0, cutPoly))
+			|| !std::isinf(metronome::GetNavLandmarkBound(oneWayLandmarks, 0, cutPoly))
+			|| metronome::GetNavLandmarkBound(oneWayLandmarks, cutPoly, 0) > backCost)
+		{
+			std::printf("landmark bound misses a one way cut\n");
+			return 1;
+		}
+	}
+	return 0;
+}
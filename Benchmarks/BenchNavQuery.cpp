@@ -0,0 +1,73 @@
+#include "Bench.h"
+#include "NavGrid.h"
+#include "ExportCore/NavBvh.h"
+#include <array>
+#include <cmath>
+#include <random>
+
+//the per triangle scan the bvh replaces
+static int FindNavTriangleBruteForce(const std::vector<float>& somePositions, const std::vector<std::uint32_t>& someIndices, const float aPoint[3], float aMaxHeight)
+{
+	const metronome::NavBvhNode everything = { { -1e30f, -1e30f, -1e30f }, { 1e30f, 1e30f, 1e30f }, 0, static_cast<std::uint32_t>(someIndices.size() / 3) };
+	std::vector<std::uint32_t> triangles(someIndices.size() / 3);
+	for (size_t i = 0; i < triangles.size(); ++i)
+	{
+		triangles[i] = static_cast<std::uint32_t>(i);
+	}
+	return metronome::FindNavTriangle({ everything }, triangles.data(), somePositions.data(), someIndices.data(), aPoint, aMaxHeight);
+}
+
+int main(int argc, char** argv)
+{
+	for (int size : bench::GetSizes(argc, argv, { 10000, 200000 }))
+	{
+		const metronome::NavMesh mesh = metronome::MergeTileMeshes(BuildTileMeshes(MakeGridTiles(size)), 0.0f);
+
+		metronome::NavBvh bvh;
+		bench::Measure("build bvh", size, 3, [&] {
+			bvh = metronome::BuildNavBvh(mesh);
+		});
+
+		std::vector<float> positions;
+		for (const metronome::Vec3& vertex : mesh.myVertices)
+		{
+			const metronome::Vec3 exportVertex = metronome::ToExportVector(vertex);
+			positions.insert(positions.end(), { exportVertex.x, exportVertex.y, exportVertex.z });
+		}
+		std::vector<std::uint32_t> indices;
+		for (const metronome::Face& face : mesh.myFaces)
+		{
+			indices.insert(indices.end(), { face.x - 1, face.y - 1, face.z - 1 });
+		}
+
+		//the grid lies in x/z of the export space, some points miss it
+		const float extent = std::sqrt(static_cast<float>(size)) * cellSize;
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> pickCoordinate(-0.1f * extent, 1.1f * extent);
+		std::uniform_real_distribution<float> pickHeight(-20.0f, 20.0f);
+		std::vector<std::array<float, 3>> points(10000);
+		for (std::array<float, 3>& point : points)
+		{
+			point = { pickCoordinate(random), pickHeight(random), pickCoordinate(random) };
+		}
+
+		std::vector<int> found(points.size());
+		bench::Measure("10000 bvh point queries", size, 3, [&] {
+			for (size_t i = 0; i < points.size(); ++i)
+			{
+				found[i] = metronome::FindNavTriangle(bvh.myNodes, bvh.myTriangles.data(), positions.data(), indices.data(), points[i].data(), 10.0f);
+			}
+		});
+		bench::Measure("100 brute force point queries", size, 1, [&] {
+			for (size_t i = 0; i < 100; ++i)
+			{
+				if ((FindNavTriangleBruteForce(positions, indices, points[i].data(), 10.0f) == -1) != (found[i] == -1))
+				{
+					std::printf("bvh query disagrees with brute force at point %zu\n", i);
+					std::exit(1);
+				}
+			}
+		});
+	}
+	return 0;
+}
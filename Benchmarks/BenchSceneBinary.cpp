@@ -0,0 +1,94 @@
+#include "Bench.h"
+#include "FabScene.h"
+#include "ExportCore/SceneBinary.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+static std::vector<unsigned char> ReadFile(const std::string& aPath)
+{
+	std::ifstream file(aPath, std::ios::binary);
+	return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+template <typename T>
+static const T* FindTable(const metronome::NavBinaryView& aView, std::uint32_t anId, size_t& aCountOut)
+{
+	size_t size = 0;
+	const T* table = static_cast<const T*>(aView.FindSection(anId, &size));
+	aCountOut = size / sizeof(T);
+	return table;
+}
+
+int main(int argc, char** argv)
+{
+	const std::string fabPath = "BenchSceneBinary.fab";
+	const std::string binaryPath = "BenchSceneBinary.mscn";
+
+	for (int size : bench::GetSizes(argc, argv, { 10000, 100000 }))
+	{
+		const metronome::SceneSnapshot snapshot = MakeSceneSnapshot(MakeEntities(size));
+
+		{
+			metronome::FabWriter writer(true);
+			writer.Open(fabPath);
+			metronome::WriteScene(writer, snapshot);
+			writer.Close();
+		}
+		bool succeeded = false;
+		bench::Measure("write mscn", size, 3, [&] {
+			succeeded = metronome::WriteSceneBinary(binaryPath, snapshot);
+		});
+
+		//what a loader does before it can read a transform
+		float checksum = 0.0f;
+		bench::Measure("load + parse fab", size, 3, [&] {
+			const std::vector<unsigned char> data = ReadFile(fabPath);
+			const nlohmann::json scene = nlohmann::json::parse(data);
+			checksum = scene["root"]["components"][1]["params"]["children"][1]["components"][0]["params"]["name"].get<std::string>().size();
+		});
+		std::vector<unsigned char> data;
+		bench::Measure("load + validate mscn", size, 3, [&] {
+			data = ReadFile(binaryPath);
+			metronome::NavBinaryView view;
+			succeeded &= view.Init(data.data(), data.size(), metronome::sceneBinaryMagic);
+		});
+		std::printf("%-32s %10d %12zu bytes\n", "fab size", size, ReadFile(fabPath).size());
+		std::printf("%-32s %10d %12zu bytes\n", "mscn size", size, data.size());
+
+		//every table has to read back in place to what the snapshot holds
+		metronome::NavBinaryView view;
+		size_t entityCount = 0;
+		size_t transformCount = 0;
+		size_t meshRendererCount = 0;
+		size_t stringSize = 0;
+		succeeded &= view.Init(data.data(), data.size(), metronome::sceneBinaryMagic);
+		const metronome::SceneBinaryEntity* entities = FindTable<metronome::SceneBinaryEntity>(view, metronome::SceneSection::entities, entityCount);
+		const metronome::SceneBinaryTransform* transforms = FindTable<metronome::SceneBinaryTransform>(view, metronome::SceneSection::transforms, transformCount);
+		const metronome::SceneBinaryMeshRenderer* meshRenderers = FindTable<metronome::SceneBinaryMeshRenderer>(view, metronome::SceneSection::meshRenderers, meshRendererCount);
+		const char* strings = FindTable<char>(view, metronome::SceneSection::strings, stringSize);
+		succeeded &= entityCount == snapshot.myEntities.size() && transformCount == snapshot.myTransforms.size() && meshRendererCount == snapshot.myMeshRenderers.size();
+		for (size_t i = 0; succeeded && i < entityCount; ++i)
+		{
+			const metronome::SceneEntity& src = snapshot.myEntities[i];
+			succeeded &= src.myName == strings + entities[i].myName
+				&& static_cast<std::int32_t>(entities[i].myParent) == src.myParent
+				&& (entities[i].myTransform == metronome::sceneNoEntity) == src.myIsFolder;
+			if (!src.myIsFolder)
+			{
+				const metronome::Vec3 position = metronome::ToExportVector(snapshot.myTransforms[entities[i].myTransform].myData.myLocation * 0.01f);
+				succeeded &= transforms[entities[i].myTransform].myEntity == i && std::memcmp(&position, transforms[entities[i].myTransform].myPosition, sizeof(position)) == 0;
+			}
+		}
+		for (size_t i = 0; succeeded && i < meshRendererCount; ++i)
+		{
+			succeeded &= snapshot.myMeshRenderers[i].myData.myModelPath == strings + meshRenderers[i].myModelPath;
+		}
+		if (!succeeded || checksum == 0.0f)
+		{
+			std::printf("mscn doesn't match the snapshot\n");
+			return 1;
+		}
+	}
+	return 0;
+}
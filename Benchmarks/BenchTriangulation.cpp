@@ -0,0 +1,120 @@
+#include "Bench.h"
+#include "ExportCore/Delaunay.h"
+#include <cmath>
+#include <random>
+
+//the empty circumcircle check is quadratic, larger sizes only check coverage and winding
+constexpr int maxDelaunayCheckSize = 2000;
+
+static double Orient(const delaunay::Point<float>& aA, const delaunay::Point<float>& aB, const delaunay::Point<float>& aC)
+{
+	return (static_cast<double>(aB.x) - aA.x) * (static_cast<double>(aC.y) - aA.y) - (static_cast<double>(aB.y) - aA.y) * (static_cast<double>(aC.x) - aA.x);
+}
+
+//positive when aD is inside the circumcircle of the counter-clockwise aA, aB, aC, scaled down by the size of the terms
+static double InCircle(const delaunay::Point<float>& aA, const delaunay::Point<float>& aB, const delaunay::Point<float>& aC, const delaunay::Point<float>& aD)
+{
+	const double ax = static_cast<double>(aA.x) - aD.x, ay = static_cast<double>(aA.y) - aD.y;
+	const double bx = static_cast<double>(aB.x) - aD.x, by = static_cast<double>(aB.y) - aD.y;
+	const double cx = static_cast<double>(aC.x) - aD.x, cy = static_cast<double>(aC.y) - aD.y;
+	const double a = ax * ax + ay * ay, b = bx * bx + by * by, c = cx * cx + cy * cy;
+	const double det = a * (bx * cy - cx * by) - b * (ax * cy - cx * ay) + c * (ax * by - bx * ay);
+	const double scale = a * (std::abs(bx * cy) + std::abs(cx * by)) + b * (std::abs(ax * cy) + std::abs(cx * ay)) + c * (std::abs(ax * by) + std::abs(bx * ay));
+	return scale > 0.0 ? det / scale : 0.0;
+}
+
+//null when the triangulation covers every point with counter-clockwise triangles that have empty circumcircles
+static const char* CheckTriangulation(const std::vector<delaunay::Point<float>>& somePoints, const delaunay::Delaunay<float>& aTriangulation, bool aShouldCheckCircles)
+{
+	std::vector<char> isCovered(somePoints.size(), 0);
+	for (const std::array<int, 3>& triangle : aTriangulation.indices)
+	{
+		for (int index : triangle)
+		{
+			if (index < 0 || index >= static_cast<int>(somePoints.size()))
+			{
+				return "triangle index out of range";
+			}
+			isCovered[index] = 1;
+		}
+		if (Orient(somePoints[triangle[0]], somePoints[triangle[1]], somePoints[triangle[2]]) <= 0.0)
+		{
+			return "triangle is not counter-clockwise";
+		}
+	}
+	if (std::find(isCovered.begin(), isCovered.end(), 0) != isCovered.end())
+	{
+		return "a point is not part of any triangle";
+	}
+	if (!aShouldCheckCircles)
+	{
+		return nullptr;
+	}
+
+	for (const std::array<int, 3>& triangle : aTriangulation.indices)
+	{
+		for (int i = 0; i < static_cast<int>(somePoints.size()); ++i)
+		{
+			if (i != triangle[0] && i != triangle[1] && i != triangle[2]
+				&& InCircle(somePoints[triangle[0]], somePoints[triangle[1]], somePoints[triangle[2]], somePoints[i]) > 1e-9)
+			{
+				return "a point is inside a triangle's circumcircle";
+			}
+		}
+	}
+	return nullptr;
+}
+
+//convex outlines like the ones detour polys have, with extra vertices on straight edges where tiles or polys meet
+static std::vector<std::vector<delaunay::Point<float>>> MakeNavPolygons()
+{
+	std::vector<std::vector<delaunay::Point<float>>> polygons;
+	polygons.push_back({ { 0, 0, 0 }, { 300, 0, 0 }, { 300, 200, 0 } });
+	polygons.push_back({ { 0, 0, 0 }, { 300, 0, 0 }, { 300, 200, 0 }, { 0, 200, 0 } });
+	polygons.push_back({ { 0, 0, 0 }, { 100, 0, 0 }, { 200, 0, 0 }, { 300, 0, 0 }, { 300, 200, 0 }, { 0, 200, 0 } });
+	polygons.push_back({ { 0, 0, 0 }, { 150, 0, 0 }, { 300, 0, 0 }, { 300, 100, 0 }, { 300, 200, 0 }, { 150, 200, 0 }, { 0, 200, 0 }, { 0, 100, 0 } });
+	polygons.push_back({ { 0, 0, 0 }, { 200, -50, 0 }, { 400, 0, 0 }, { 450, 150, 0 }, { 400, 300, 0 }, { 200, 350, 0 }, { 0, 300, 0 }, { -50, 150, 0 } });
+	polygons.push_back({ { -1200.5f, 3400.25f, 12 }, { -1150.5f, 3400.25f, 12 }, { -1100.5f, 3400.25f, 13 }, { -1100.5f, 3450.25f, 13 }, { -1200.5f, 3450.25f, 12 } });
+	return polygons;
+}
+
+int main(int argc, char** argv)
+{
+	//a convex outline of n vertices triangulates into n - 2 triangles, collinear vertices included
+	for (const std::vector<delaunay::Point<float>>& polygon : MakeNavPolygons())
+	{
+		const delaunay::Delaunay<float> triangulation = delaunay::triangulate<float>(polygon);
+		const char* error = CheckTriangulation(polygon, triangulation, true);
+		if (error == nullptr && triangulation.indices.size() != polygon.size() - 2)
+		{
+			error = "convex polygon has the wrong triangle count";
+		}
+		if (error != nullptr)
+		{
+			std::printf("%zu vertex polygon: %s\n", polygon.size(), error);
+			return 1;
+		}
+	}
+
+	for (int size : bench::GetSizes(argc, argv, { 6, 1000, 10000, 100000 }))
+	{
+		std::mt19937 rng(size);
+		std::uniform_real_distribution<float> coord(-50000.0f, 50000.0f);
+		std::vector<delaunay::Point<float>> points;
+		for (int i = 0; i < size; ++i)
+		{
+			points.emplace_back(coord(rng), coord(rng), 0.0f);
+		}
+
+		delaunay::Delaunay<float> triangulation;
+		bench::Measure("triangulate", size, 5, [&] {
+			triangulation = delaunay::triangulate<float>(points);
+		});
+		if (const char* error = CheckTriangulation(points, triangulation, size <= maxDelaunayCheckSize))
+		{
+			std::printf("%d random points: %s\n", size, error);
+			return 1;
+		}
+	}
+	return 0;
+}
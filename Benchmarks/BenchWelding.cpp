@@ -0,0 +1,128 @@
+#include "Bench.h"
+#include "NavGrid.h"
+#include "ExportCore/NavSimplify.h"
+#include "ExportCore/NavTileCache.h"
+#include <cmath>
+
+static bool IsSameMesh(const metronome::NavMesh& aA, const metronome::NavMesh& aB)
+{
+	if (aA.myVertices != aB.myVertices || aA.myFaces.size() != aB.myFaces.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < aA.myFaces.size(); ++i)
+	{
+		const metronome::Face& a = aA.myFaces[i];
+		const metronome::Face& b = aB.myFaces[i];
+		if (a.x != b.x || a.y != b.y || a.z != b.z)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static double GetArea(const metronome::NavMesh& aMesh)
+{
+	double area = 0.0;
+	for (const metronome::Face& face : aMesh.myFaces)
+	{
+		const metronome::Vec3& a = aMesh.myVertices[face.x - 1];
+		const metronome::Vec3& b = aMesh.myVertices[face.y - 1];
+		const metronome::Vec3& c = aMesh.myVertices[face.z - 1];
+		area += std::abs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) * 0.5;
+	}
+	return area;
+}
+
+int main(int argc, char** argv)
+{
+	for (int size : bench::GetSizes(argc, argv, { 1000, 10000 }))
+	{
+		const std::vector<std::vector<Poly>> tiles = MakeGridTiles(size);
+
+		metronome::NavMesh serial;
+		bench::Measure("weld + triangulate polys", size, 3, [&] {
+			metronome::NavMeshBuilder builder;
+			for (const std::vector<Poly>& tile : tiles)
+			{
+				for (const Poly& poly : tile)
+				{
+					builder.AddPolygon(poly);
+				}
+			}
+			serial = builder.TakeMesh();
+		});
+
+		std::vector<metronome::NavTileMesh> tileMeshes;
+		bench::Measure("per tile weld + triangulate", size, 3, [&] {
+			tileMeshes = BuildTileMeshes(tiles);
+		});
+
+		metronome::NavMesh merged;
+		bench::Measure("merge tiles", size, 3, [&] {
+			merged = metronome::MergeTileMeshes(tileMeshes, 0.0f);
+		});
+		if (serial.myVertices.empty() || !IsSameMesh(serial, merged))
+		{
+			std::printf("merged tiles differ from the serial build\n");
+			return 1;
+		}
+
+		//the grid is flat, every tile should collapse into few polys covering the same area
+		std::vector<metronome::NavTileMesh> simplifiedMeshes(tiles.size());
+		bench::Measure("simplify + triangulate tiles", size, 3, [&] {
+			for (size_t i = 0; i < tiles.size(); ++i)
+			{
+				std::vector<metronome::NavPolygon> polygons;
+				for (size_t j = 0; j < tiles[i].size(); ++j)
+				{
+					polygons.push_back({ tiles[i][j], static_cast<std::uint32_t>(j), 0 });
+				}
+				metronome::NavMeshBuilder builder;
+				for (const metronome::NavPolygon& polygon : metronome::SimplifyNavPolygons(polygons, 1.0f))
+				{
+					builder.SetSourcePoly(polygon.myPoly);
+					builder.AddPolygon(polygon.myVertices);
+				}
+				simplifiedMeshes[i].myIsValid = true;
+				simplifiedMeshes[i].myX = static_cast<int>(i);
+				simplifiedMeshes[i].myMesh = builder.TakeMesh();
+			}
+		});
+		const metronome::NavMesh simplified = metronome::MergeTileMeshes(simplifiedMeshes, 0.0f);
+		std::printf("simplified %zu triangles to %zu\n", serial.myFaces.size(), simplified.myFaces.size());
+		if (std::abs(GetArea(simplified) - GetArea(serial)) > 1e-6 * GetArea(serial) || simplified.myFaces.size() >= serial.myFaces.size())
+		{
+			std::printf("simplified mesh doesn't cover the same area\n");
+			return 1;
+		}
+
+		//a re-export where nothing changed, every tile comes from the cache
+		const std::string cachePath = "BenchWelding.tilecache";
+		for (size_t i = 0; i < tileMeshes.size(); ++i)
+		{
+			tileMeshes[i].myHash = i + 1;
+		}
+		bench::Measure("save tile cache", size, 3, [&] {
+			metronome::NavTileCache::Save(cachePath, tileMeshes);
+		});
+		std::vector<metronome::NavTileMesh> cachedMeshes;
+		bench::Measure("load + splice tile cache", size, 3, [&] {
+			metronome::NavTileCache cache;
+			cache.Load(cachePath);
+			cachedMeshes = tileMeshes;
+			for (metronome::NavTileMesh& tileMesh : cachedMeshes)
+			{
+				tileMesh.myMesh = {};
+				cache.TakeMesh(tileMesh.myX, tileMesh.myY, tileMesh.myLayer, tileMesh.myHash, tileMesh.myMesh);
+			}
+		});
+		if (!IsSameMesh(serial, metronome::MergeTileMeshes(cachedMeshes, 0.0f)))
+		{
+			std::printf("cached tiles differ from the serial build\n");
+			return 1;
+		}
+	}
+	return 0;
+}
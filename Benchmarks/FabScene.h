@@ -0,0 +1,126 @@
+#pragma once
+
+#include "ExportCore/FabJson.h"
+#include "ExportCore/FabWriter.h"
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+//the scene both writers get fed, one entity per actor
+struct BenchEntity
+{
+	std::string myName;
+	metronome::Transform myTransform;
+	metronome::MeshRenderer myMeshRenderer;
+	bool myHasLight = false;
+	metronome::SpotLight myLight;
+	std::vector<BenchEntity> myChildren;
+};
+
+inline std::vector<BenchEntity> MakeEntities(int anEntityCount)
+{
+	std::mt19937 rng(anEntityCount);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	std::vector<BenchEntity> entities(anEntityCount);
+	for (int i = 0; i < anEntityCount; ++i)
+	{
+		BenchEntity& entity = entities[i];
+		//a few names that need escaping
+		entity.myName = i % 97 == 0 ? "Actor \"" + std::to_string(i) + "\"\t\\\x01 \xc3\xbc" : "Actor" + std::to_string(i);
+		entity.myTransform.myLocation = { unit(rng) * 10000, unit(rng) * 10000, unit(rng) * 1000 };
+		entity.myTransform.myRotation = { 0, 0, unit(rng), 1 };
+		entity.myTransform.myScale = { 1, 1, -1 };
+		entity.myMeshRenderer.myModelPath = "Assets/Models/Prop" + std::to_string(i % 64) + ".wardh";
+		if (i % 7 != 0)
+		{
+			entity.myMeshRenderer.myMaterialPaths.push_back("Assets/Materials/Prop" + std::to_string(i % 16) + ".mat");
+		}
+		entity.myHasLight = i % 10 == 0;
+		entity.myLight.myColor = { 1, 0.9f, 0.8f, 1 };
+		entity.myLight.myIntensity = i % 20 == 0 ? std::numeric_limits<float>::quiet_NaN() : 5000;
+		entity.myLight.myAttenuationRadius = 1000;
+		entity.myLight.myInnerConeAngle = 0.3f;
+		entity.myLight.myOuterConeAngle = -0.0f;
+		if (i % 5 == 0)
+		{
+			entity.myChildren.push_back(entity);
+		}
+	}
+	return entities;
+}
+
+inline nlohmann::json CreateEntityJson(const BenchEntity& anEntity)
+{
+	std::vector<nlohmann::json> children;
+	for (const BenchEntity& child : anEntity.myChildren)
+	{
+		children.push_back(CreateEntityJson(child));
+	}
+
+	nlohmann::json components;
+	components.push_back(metronome::CreateComponentJson("NameTag", metronome::CreateNameTagJson(anEntity.myName)));
+	components.push_back(metronome::CreateComponentJson("Parent", metronome::CreateParentJson(children)));
+	components.push_back(metronome::CreateComponentJson("Transform", metronome::CreateTransformJson(anEntity.myTransform)));
+	if (anEntity.myHasLight)
+	{
+		components.push_back(metronome::CreateComponentJson("PointLight", metronome::CreatePointLightJson(anEntity.myLight)));
+		components.push_back(metronome::CreateComponentJson("SpotLight", metronome::CreateSpotLightJson(anEntity.myLight)));
+	}
+	components.push_back(metronome::CreateComponentJson("MeshRenderer", metronome::CreateMeshRendererJson(anEntity.myMeshRenderer)));
+	return metronome::CreateEntityJson(components);
+}
+
+//folders of 100 entities, plus an empty one
+inline nlohmann::json CreateSceneJson(const std::vector<BenchEntity>& someEntities)
+{
+	std::vector<nlohmann::json> folders;
+	folders.push_back(metronome::CreateFolderEntityJson("Empty", {}, {}));
+	std::vector<nlohmann::json> children;
+	for (size_t i = 0; i < someEntities.size(); ++i)
+	{
+		children.push_back(CreateEntityJson(someEntities[i]));
+		if (children.size() == 100 || i + 1 == someEntities.size())
+		{
+			folders.push_back(metronome::CreateFolderEntityJson("Folder" + std::to_string(folders.size()), {}, children));
+			children.clear();
+		}
+	}
+	return metronome::CreateSceneJson(metronome::CreateFolderEntityJson("UnrealScene", folders, {}));
+}
+
+inline void AddSnapshotEntity(metronome::SceneSnapshot& aSnapshot, const BenchEntity& anEntity, std::int32_t aParent)
+{
+	const std::uint32_t entity = static_cast<std::uint32_t>(aSnapshot.myEntities.size());
+	aSnapshot.myEntities.push_back({ anEntity.myName, aParent, false });
+	aSnapshot.myTransforms.push_back({ entity, anEntity.myTransform });
+	if (anEntity.myHasLight)
+	{
+		aSnapshot.myPointLights.push_back({ entity, anEntity.myLight });
+		aSnapshot.mySpotLights.push_back({ entity, anEntity.myLight });
+	}
+	aSnapshot.myMeshRenderers.push_back({ entity, anEntity.myMeshRenderer });
+	for (const BenchEntity& child : anEntity.myChildren)
+	{
+		AddSnapshotEntity(aSnapshot, child, static_cast<std::int32_t>(entity));
+	}
+}
+
+//the same scene as CreateSceneJson
+inline metronome::SceneSnapshot MakeSceneSnapshot(const std::vector<BenchEntity>& someEntities)
+{
+	metronome::SceneSnapshot snapshot;
+	snapshot.myEntities.push_back({ "UnrealScene", -1, true });
+	snapshot.myEntities.push_back({ "Empty", 0, true });
+	for (size_t begin = 0; begin < someEntities.size(); begin += 100)
+	{
+		const std::int32_t folder = static_cast<std::int32_t>(snapshot.myEntities.size());
+		snapshot.myEntities.push_back({ "Folder" + std::to_string(begin / 100 + 1), 0, true });
+		for (size_t i = begin; i < someEntities.size() && i < begin + 100; ++i)
+		{
+			AddSnapshotEntity(snapshot, someEntities[i], folder);
+		}
+	}
+	return snapshot;
+}
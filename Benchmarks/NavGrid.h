@@ -0,0 +1,107 @@
+#pragma once
+
+#include "ExportCore/NavGraph.h"
+#include "ExportCore/NavMesh.h"
+#include <algorithm>
+#include <vector>
+
+using Poly = std::vector<metronome::Vec3>;
+
+constexpr int tileSize = 16;
+constexpr float cellSize = 50.0f;
+
+inline int GetGridSide(int aVertexCount)
+{
+	int side = 2;
+	while ((side + 1) * (side + 1) < aVertexCount)
+	{
+		++side;
+	}
+	return side;
+}
+
+//a grid of quads shaped like recast output, every inner vertex is shared by four polys.
+//polys are grouped into tiles of 16x16 cells like detour would, border vertices are shared between tiles
+inline std::vector<std::vector<Poly>> MakeGridTiles(int aVertexCount)
+{
+	const int side = GetGridSide(aVertexCount);
+	const int tilesPerSide = (side + tileSize - 1) / tileSize;
+	std::vector<std::vector<Poly>> tiles(tilesPerSide * tilesPerSide);
+	for (int y = 0; y < side; ++y)
+	{
+		for (int x = 0; x < side; ++x)
+		{
+			const float x0 = x * cellSize, x1 = (x + 1) * cellSize;
+			const float y0 = y * cellSize, y1 = (y + 1) * cellSize;
+			tiles[(y / tileSize) * tilesPerSide + x / tileSize].push_back({ { x0, y0, 0 }, { x1, y0, 0 }, { x1, y1, 0 }, { x0, y1, 0 } });
+		}
+	}
+	return tiles;
+}
+
+//per tile builds the way the exporter runs them on the task graph
+inline std::vector<metronome::NavTileMesh> BuildTileMeshes(const std::vector<std::vector<Poly>>& someTiles)
+{
+	std::vector<metronome::NavTileMesh> tileMeshes(someTiles.size());
+	for (size_t i = 0; i < someTiles.size(); ++i)
+	{
+		metronome::NavMeshBuilder builder;
+		for (const Poly& poly : someTiles[i])
+		{
+			builder.AddPolygon(poly);
+		}
+		tileMeshes[i].myIsValid = true;
+		tileMeshes[i].myX = static_cast<int>(i);
+		tileMeshes[i].myMesh = builder.TakeMesh();
+	}
+	return tileMeshes;
+}
+
+//the adjacency detour would link for MakeGridTiles, every cell linked to its four neighbours
+inline std::vector<metronome::NavTileGraph> MakeGridTileGraphs(int aVertexCount)
+{
+	const int side = GetGridSide(aVertexCount);
+	const int tilesPerSide = (side + tileSize - 1) / tileSize;
+	auto getTarget = [&](int aX, int aY) {
+		const int tileX = aX / tileSize;
+		const int tileWidth = std::min(tileSize, side - tileX * tileSize);
+		return metronome::NavLinkTarget{ (aY / tileSize) * tilesPerSide + tileX, (aY % tileSize) * tileWidth + aX % tileSize };
+	};
+
+	std::vector<metronome::NavTileGraph> graphs(tilesPerSide * tilesPerSide);
+	for (metronome::NavTileGraph& graph : graphs)
+	{
+		graph.myIsValid = true;
+	}
+	for (int y = 0; y < side; ++y)
+	{
+		for (int x = 0; x < side; ++x)
+		{
+			const metronome::NavLinkTarget self = getTarget(x, y);
+			metronome::NavTileGraph& graph = graphs[self.myTile];
+			graph.myCentroids.push_back({ (x + 0.5f) * cellSize, (y + 0.5f) * cellSize, 0 });
+			graph.myLinkOffsets.push_back(static_cast<std::uint32_t>(graph.myLinkTargets.size()));
+
+			const float x0 = x * cellSize, x1 = (x + 1) * cellSize;
+			const float y0 = y * cellSize, y1 = (y + 1) * cellSize;
+			const int neighbours[4][2] = { { x, y - 1 }, { x + 1, y }, { x, y + 1 }, { x - 1, y } };
+			const metronome::Vec3 portals[4][2] = {
+				{ { x0, y0, 0 }, { x1, y0, 0 } }, { { x1, y0, 0 }, { x1, y1, 0 } },
+				{ { x1, y1, 0 }, { x0, y1, 0 } }, { { x0, y1, 0 }, { x0, y0, 0 } } };
+			for (int i = 0; i < 4; ++i)
+			{
+				if (neighbours[i][0] >= 0 && neighbours[i][0] < side && neighbours[i][1] >= 0 && neighbours[i][1] < side)
+				{
+					graph.myLinkTargets.push_back(getTarget(neighbours[i][0], neighbours[i][1]));
+					graph.myPortals.push_back(portals[i][0]);
+					graph.myPortals.push_back(portals[i][1]);
+				}
+			}
+		}
+	}
+	for (metronome::NavTileGraph& graph : graphs)
+	{
+		graph.myLinkOffsets.push_back(static_cast<std::uint32_t>(graph.myLinkTargets.size()));
+	}
+	return graphs;
+}
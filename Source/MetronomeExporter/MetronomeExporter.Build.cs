@@ -1,5 +1,6 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
+using System.IO;
 using UnrealBuildTool;
 
 public class MetronomeExporter : ModuleRules
@@ -7,6 +8,7 @@ public class MetronomeExporter : ModuleRules
 	public MetronomeExporter(ReadOnlyTargetRules Target) : base(Target)
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		CppStandard = CppStandardVersion.Cpp17; //the export core uses <charconv>, std::clamp and friends, 4.27 defaults to C++14
 		
 
 		PublicIncludePaths.AddRange(new string[] {
@@ -15,6 +17,7 @@ public class MetronomeExporter : ModuleRules
 				
 		
 		PrivateIncludePaths.AddRange(new string[] {
+			Path.Combine(ModuleDirectory, "Private"), //engine independent export core lives in Private/ExportCore
 			// ... add other private include paths required here ...
 		});
 			
@@ -3,6 +3,7 @@
 #include "NavMesh/RecastNavMesh.h"
 #include "NavigationSystem.h"
 #include "NavigationSystem\Public\NavMesh\PImplRecastNavMesh.h"
+#include "NavMesh/RecastHelpers.h"
 #include "Components/LightComponent.h"
 #include "Components/PointLightComponent.h"
 #include "Components/SpotLightComponent.h"
@@ -12,362 +13,631 @@
 #include "Camera/CameraComponent.h"
 #include "EditorFramework/AssetImportData.h"
 #include "Kismet/GameplayStatics.h"
-#include <fstream>
-#include <iomanip>
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "ExportCore/FabWriter.h"
+#include "ExportCore/NavBinary.h"
+#include "ExportCore/Hash.h"
+#include "ExportCore/NavAreas.h"
+#include "ExportCore/NavBvh.h"
+#include "ExportCore/NavChunks.h"
+#include "ExportCore/NavGraph.h"
+#include "ExportCore/NavHierarchy.h"
+#include "ExportCore/NavIslands.h"
+#include "ExportCore/NavLandmarks.h"
+#include "ExportCore/NavMesh.h"
+#include "ExportCore/NavSimplify.h"
+#include "ExportCore/NavTileCache.h"
+#include "ExportCore/NavTilePool.h"
+#include "ExportCore/NavTileSet.h"
+#include "ExportCore/ObjWriter.h"
+#include "ExportCore/SceneBinary.h"
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#undef min
-#undef max
-
 DEFINE_LOG_CATEGORY(LogExporter);
 
-#pragma region Triangulation
+struct NavMeshDeleter
+{
+	void operator()(dtNavMesh* aNavMesh) const { dtFreeNavMesh(aNavMesh); }
+};
 
-#include <algorithm>
-#include <vector>
-namespace delaunay
+struct UExport::NavDataSnapshot
 {
-	constexpr double eps = 1e-4;
+	std::string myOutPathNoExt;
+	std::unique_ptr<dtNavMesh, NavMeshDeleter> myNavMesh; //private copy, the world's nav mesh keeps rebuilding tiles while we write
+	std::vector<metronome::NavAreaCost> myAreaCosts;
+};
 
-	template <typename T>
-	struct Point
+struct UExport::ExportSnapshot
+{
+	std::string myScenePath;
+	metronome::SceneSnapshot myScene;
+	std::vector<NavDataSnapshot> myNavData;
+};
+
+UExport::UExport()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+// Called every frame
+void UExport::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+// Called when the game starts
+void UExport::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UE_LOG(LogExporter, Display, TEXT("New export started!"));
+
+	ExportSnapshot snapshot;
+	SnapshotExport(snapshot);
+	if (shouldExportAsync)
+	{
+		exportTask = Async(EAsyncExecution::Thread, [this, snapshot = MoveTemp(snapshot)]() {
+			WriteExport(snapshot);
+		});
+	}
+	else
+	{
+		WriteExport(snapshot);
+	}
+}
+
+void UExport::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//the background export reads our settings until it is done
+	if (exportTask.IsValid())
 	{
-		T x, y, z;
+		exportTask.Wait();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
-		Point() : x{ 0 }, y{ 0 }, z{ 0 } {}
-		Point(T _x, T _y, T _z) : x{ _x }, y{ _y }, z{ _z } {}
+void UExport::SnapshotExport(ExportSnapshot& aSnapshot)
+{
+	const std::string stdSceneExportName = TCHAR_TO_UTF8(*sceneExportName);
+	const std::string stdSceneExportPath = TCHAR_TO_UTF8(*sceneExportPath);
+	const std::string sceneExtension = sceneExportFormat == ESceneExportFormat::Mscn ? ".mscn" : metronome::GetFabExtension(static_cast<metronome::FabFormat>(sceneExportFormat));
+	aSnapshot.myScenePath = stdSceneExportPath + "/" + stdSceneExportName + sceneExtension;
+	SnapshotScene(aSnapshot.myScene);
+	SnapshotNavMesh(stdSceneExportPath + "/" + stdSceneExportName + "Nav", aSnapshot.myNavData);
+}
 
-		template <typename U>
-		Point(U _x, U _y, U _z) : x{ static_cast<T>(_x) }, y{ static_cast<T>(_y) }, z{ static_cast<T>(_z) }
+void UExport::WriteExport(const ExportSnapshot& aSnapshot)
+{
+	//the scene and every agent's nav data count as one step each
+	const int stepCount = 1 + static_cast<int>(aSnapshot.myNavData.size());
+	std::atomic<int> finishedStepCount(0);
+	std::atomic<bool> succeeded(WriteSceneFile(aSnapshot.myScenePath, aSnapshot.myScene));
+	ReportProgress(static_cast<float>(++finishedStepCount) / stepCount);
+
+	//agents are exported concurrently and share tiles that came out identical, a single agent has nobody to share with
+	std::unique_ptr<metronome::NavTilePool> pool;
+	if (aSnapshot.myNavData.size() > 1)
+	{
+		pool = std::make_unique<metronome::NavTilePool>();
+	}
+	ParallelFor(static_cast<int32>(aSnapshot.myNavData.size()), [&](int32 anIndex) {
+		if (!ExportNavData(aSnapshot.myNavData[anIndex], pool.get()))
 		{
+			succeeded = false;
 		}
+		ReportProgress(static_cast<float>(++finishedStepCount) / stepCount);
+	});
+
+	if (succeeded)
+	{
+		UE_LOG(LogExporter, Display, TEXT("Saved export to \"%s\""), *sceneExportPath);
+	}
+	ReportCompletion(succeeded);
+}
+
+void UExport::ReportProgress(float aProgress)
+{
+	if (IsInGameThread())
+	{
+		onExportProgress.Broadcast(aProgress);
+		return;
+	}
 
-		friend std::ostream& operator<<(std::ostream& os, const Point<T>& p)
+	TWeakObjectPtr<UExport> weakThis(this);
+	AsyncTask(ENamedThreads::GameThread, [weakThis, aProgress]() {
+		if (UExport* exporter = weakThis.Get())
 		{
-			os << "x=" << p.x << "  y=" << p.y;
-			return os;
+			exporter->onExportProgress.Broadcast(aProgress);
 		}
+	});
+}
+
+void UExport::ReportCompletion(bool aHasSucceeded)
+{
+	if (IsInGameThread())
+	{
+		onExportCompleted.Broadcast(aHasSucceeded);
+		return;
+	}
 
-		bool operator==(const Point<T>& other) const
+	TWeakObjectPtr<UExport> weakThis(this);
+	AsyncTask(ENamedThreads::GameThread, [weakThis, aHasSucceeded]() {
+		if (UExport* exporter = weakThis.Get())
 		{
-			return (other.x == x && other.y == y);
+			exporter->onExportCompleted.Broadcast(aHasSucceeded);
 		}
+	});
+}
 
-		bool operator!=(const Point<T>& other) const { return !operator==(other); }
-	};
+static void TaskGraphParallelFor(int aCount, const std::function<void(int)>& aBody)
+{
+	ParallelFor(aCount, [&](int32 anIndex) { aBody(anIndex); });
+}
 
-	template <typename T>
-	struct Edge
+void UExport::SnapshotNavMesh(const std::string& aOutPathNoExt, std::vector<NavDataSnapshot>& someNavData)
+{
+	UNavigationSystemV1* navigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	ARecastNavMesh* defaultNavMesh = navigationSystem != nullptr ? Cast<ARecastNavMesh>(navigationSystem->GetDefaultNavDataInstance()) : nullptr;
+	if (defaultNavMesh == nullptr || defaultNavMesh->GetRecastMesh() == nullptr)
 	{
-		using Node = Point<T>;
-		Node p0, p1;
-
-		Edge(Node const& _p0, Node const& _p1) : p0{ _p0 }, p1{ _p1 } {}
+		UE_LOG(LogExporter, Warning, TEXT("No Navmesh detected, Skipping..."))
+			return;
+	}
 
-		friend std::ostream& operator<<(std::ostream& os, const Edge& e)
+	//the default agent keeps the plain name, every other agent gets its own files next to it
+	std::vector<const ARecastNavMesh*> navMeshes = { defaultNavMesh };
+	std::vector<std::string> outPaths = { aOutPathNoExt };
+	if (shouldExportAllNavData)
+	{
+		for (ANavigationData* navData : navigationSystem->NavDataSet)
 		{
-			os << "p0: [" << e.p0 << " ] p1: [" << e.p1 << "]";
-			return os;
+			const ARecastNavMesh* recastNavMesh = Cast<ARecastNavMesh>(navData);
+			if (recastNavMesh == nullptr || recastNavMesh == defaultNavMesh || recastNavMesh->GetRecastMesh() == nullptr)
+			{
+				continue;
+			}
+			navMeshes.push_back(recastNavMesh);
+			outPaths.push_back(aOutPathNoExt + "_" + TCHAR_TO_UTF8(*recastNavMesh->GetConfig().Name.ToString()));
 		}
+	}
 
-		bool operator==(const Edge& other) const
+	for (size_t i = 0; i < navMeshes.size(); ++i)
+	{
+		NavDataSnapshot navData;
+		navData.myOutPathNoExt = outPaths[i];
+		navData.myNavMesh.reset(CopyNavMesh(*navMeshes[i]->GetRecastMesh()));
+		navData.myAreaCosts = GetAreaCosts(*navMeshes[i]);
+		if (navData.myNavMesh == nullptr)
 		{
-			return ((other.p0 == p0 && other.p1 == p1) ||
-				(other.p0 == p1 && other.p1 == p0));
+			UE_LOG(LogExporter, Error, TEXT("Failed to copy navmesh for \"%s\""), UTF8_TO_TCHAR(outPaths[i].c_str()))
+			continue;
 		}
-	};
+		someNavData.push_back(std::move(navData));
+	}
+}
 
-	template <typename T>
-	struct Circle
+dtNavMesh* UExport::CopyNavMesh(const dtNavMesh& aNavMesh)
+{
+	dtNavMesh* navMesh = dtAllocNavMesh();
+	if (navMesh == nullptr || dtStatusFailed(navMesh->init(aNavMesh.getParams())))
 	{
-		T x, y, radius;
-		Circle() = default;
-	};
+		dtFreeNavMesh(navMesh);
+		return nullptr;
+	}
 
-	template <typename T>
-	struct Triangle
-	{
-		using Node = Point<T>;
-		Node p0, p1, p2;
-		Edge<T> e0, e1, e2;
-		Circle<T> circle;
-
-		Triangle(const Node& _p0, const Node& _p1, const Node& _p2)
-			: p0{ _p0 },
-			p1{ _p1 },
-			p2{ _p2 },
-			e0{ _p0, _p1 },
-			e1{ _p1, _p2 },
-			e2{ _p0, _p2 },
-			circle{}
+	//re-adding every tile under its old ref keeps tile indices and poly refs identical to the source
+	for (int i = 0; i < aNavMesh.getMaxTiles(); ++i)
+	{
+		const dtMeshTile* tile = aNavMesh.getTile(i);
+		if (tile == nullptr || tile->header == nullptr || tile->dataSize <= 0)
 		{
-			const auto ax = p1.x - p0.x;
-			const auto ay = p1.y - p0.y;
-			const auto bx = p2.x - p0.x;
-			const auto by = p2.y - p0.y;
-
-			const auto m = p1.x * p1.x - p0.x * p0.x + p1.y * p1.y - p0.y * p0.y;
-			const auto u = p2.x * p2.x - p0.x * p0.x + p2.y * p2.y - p0.y * p0.y;
-			const auto s = 1. / (2. * (ax * by - ay * bx));
-
-			circle.x = ((p2.y - p0.y) * m + (p0.y - p1.y) * u) * s;
-			circle.y = ((p0.x - p2.x) * m + (p1.x - p0.x) * u) * s;
+			continue;
+		}
 
-			const auto dx = p0.x - circle.x;
-			const auto dy = p0.y - circle.y;
-			circle.radius = dx * dx + dy * dy;
+		unsigned char* data = static_cast<unsigned char*>(dtAlloc(tile->dataSize, DT_ALLOC_PERM_TILE_DATA));
+		if (data == nullptr)
+		{
+			dtFreeNavMesh(navMesh);
+			return nullptr;
 		}
-	};
+		FMemory::Memcpy(data, tile->data, tile->dataSize);
+		if (dtStatusFailed(navMesh->addTile(data, tile->dataSize, DT_TILE_FREE_DATA, aNavMesh.getTileRef(tile), nullptr)))
+		{
+			dtFree(data, DT_ALLOC_PERM_TILE_DATA);
+			dtFreeNavMesh(navMesh);
+			return nullptr;
+		}
+	}
+	return navMesh;
+}
 
-	template <typename T>
-	struct Delaunay
+bool UExport::ExportNavData(const NavDataSnapshot& aNavData, metronome::NavTilePool* aPool) const
+{
+	const dtNavMesh* navMesh = aNavData.myNavMesh.get();
+	const std::string& outPathNoExt = aNavData.myOutPathNoExt;
+	bool succeeded = true;
+
+	//tiles whose source data didn't change since the last export are reused from the cache
+	const std::string cachePath = outPathNoExt + ".tilecache";
+	metronome::NavTileCache cache;
+	if (shouldUseNavTileCache)
 	{
-		std::vector<Triangle<T>> triangles;
-		std::vector<Edge<T>> edges;
-	};
+		cache.Load(cachePath);
+	}
 
-	template <
-		typename T,
-		typename = typename std::enable_if<std::is_floating_point<T>::value>::type>
-		Delaunay<T> triangulate(const std::vector<Point<T>>& points)
-	{
-		using Node = Point<T>;
-		if (points.size() < 3)
+	//tiles only read immutable detour data, so they are triangulated on the task graph and merged in tile order afterwards
+	std::vector<metronome::NavTileMesh> tileMeshes(navMesh->getMaxTiles());
+	const bool shouldBuildGraph = shouldExportNavBinary && shouldExportNavGraph;
+	std::vector<metronome::NavTileGraph> tileGraphs(shouldBuildGraph ? navMesh->getMaxTiles() : 0);
+	std::atomic<int> tileCount(0);
+	std::atomic<int> rebuiltTileCount(0);
+	ParallelFor(navMesh->getMaxTiles(), [&](int32 aTileIndex) {
+		const dtMeshTile* tile = navMesh->getTile(aTileIndex);
+		if (tile == nullptr || tile->header == nullptr)
+		{
+			return;
+		}
+
+		metronome::NavTileMesh& tileMesh = tileMeshes[aTileIndex];
+		tileMesh.myIsValid = true;
+		tileMesh.myX = tile->header->x;
+		tileMesh.myY = tile->header->y;
+		tileMesh.myLayer = tile->header->layer;
+		tileMesh.myHash = HashNavTile(*tile, navExportMode, navSimplifyTolerance);
+		++tileCount;
+		if (shouldBuildGraph)
 		{
-			return Delaunay<T>{};
+			GatherNavTileGraph(*navMesh, *tile, tileGraphs[aTileIndex]);
 		}
-		auto xmin = points[0].x;
-		auto xmax = xmin;
-		auto ymin = points[0].y;
-		auto ymax = ymin;
-		for (auto const& pt : points)
+		if (cache.TakeMesh(tileMesh.myX, tileMesh.myY, tileMesh.myLayer, tileMesh.myHash, tileMesh.myMesh))
 		{
-			xmin = std::min(xmin, pt.x);
-			xmax = std::max(xmax, pt.x);
-			ymin = std::min(ymin, pt.y);
-			ymax = std::max(ymax, pt.y);
+			//other agents may not have this tile cached
+			if (aPool != nullptr)
+			{
+				aPool->AddMesh(tileMesh.myHash, tileMesh.myMesh);
+			}
+			return;
+		}
+		if (aPool != nullptr && aPool->FindMesh(tileMesh.myHash, tileMesh.myMesh))
+		{
+			return;
 		}
 
-		const auto dx = xmax - xmin;
-		const auto dy = ymax - ymin;
-		const auto dmax = std::max(dx, dy);
-		const auto midx = (xmin + xmax) / static_cast<T>(2.);
-		const auto midy = (ymin + ymax) / static_cast<T>(2.);
+		metronome::NavMeshBuilder builder;
+		switch (navExportMode)
+		{
+		case ENavExportMode::Polygons:
+			GatherNavTilePolygons(*tile, navSimplifyTolerance, builder);
+			break;
+		case ENavExportMode::DetailMesh:
+			GatherNavTileDetailMesh(*tile, builder);
+			break;
+		}
+		tileMesh.myMesh = builder.TakeMesh();
+		if (aPool != nullptr)
+		{
+			aPool->AddMesh(tileMesh.myHash, tileMesh.myMesh);
+		}
+		++rebuiltTileCount;
+	});
+	UE_LOG(LogExporter, Display, TEXT("Triangulated %d of %d nav tiles for \"%s\""), rebuiltTileCount.load(), tileCount.load(), UTF8_TO_TCHAR(outPathNoExt.c_str()))
 
-		/* Init Delaunay triangulation. */
-		auto d = Delaunay<T>{};
+	if (shouldUseNavTileCache && !metronome::NavTileCache::Save(cachePath, tileMeshes))
+	{
+		UE_LOG(LogExporter, Warning, TEXT("Failed to write nav tile cache \"%s\""), UTF8_TO_TCHAR(cachePath.c_str()))
+	}
 
-		const auto p0 = Node{ midx - 20 * dmax, midy - dmax, points[0].z };
-		const auto p1 = Node{ midx, midy + 20 * dmax, points[0].z };
-		const auto p2 = Node{ midx + 20 * dmax, midy - dmax, points[0].z };
-		d.triangles.emplace_back(Triangle<T>{p0, p1, p2});
+	const metronome::NavMesh mesh = metronome::MergeTileMeshes(tileMeshes, navWeldEpsilon);
+	metronome::ObjWriteSettings objSettings;
+	objSettings.myPrecision = navObjPrecision;
+	if (!metronome::WriteObj(outPathNoExt + ".obj", mesh, objSettings, TaskGraphParallelFor))
+	{
+		UE_LOG(LogExporter, Error, TEXT("Failed to write navmesh \"%s.obj\""), UTF8_TO_TCHAR(outPathNoExt.c_str()))
+		succeeded = false;
+	}
 
-		for (auto const& pt : points)
+	if (shouldExportNavBinary)
+	{
+		metronome::NavBinaryWriter writer;
+		metronome::AddNavMeshSections(writer, mesh, shouldCompressNavBinary);
+		if (shouldExportNavBvh)
 		{
-			std::vector<Edge<T>> edges;
-			std::vector<Triangle<T>> tmps;
-			for (auto const& tri : d.triangles)
+			metronome::AddNavBvhSections(writer, metronome::BuildNavBvh(mesh));
+		}
+		if (shouldBuildGraph)
+		{
+			const metronome::NavGraph graph = metronome::MergeTileGraphs(tileGraphs);
+			metronome::AddNavGraphSections(writer, graph);
+			if (shouldExportNavAreas)
 			{
-				/* Check if the point is inside the triangle circumcircle. */
-				const auto dist = (tri.circle.x - pt.x) * (tri.circle.x - pt.x) +
-					(tri.circle.y - pt.y) * (tri.circle.y - pt.y);
-				if ((dist - tri.circle.radius) <= eps)
-				{
-					edges.push_back(tri.e0);
-					edges.push_back(tri.e1);
-					edges.push_back(tri.e2);
-				}
-				else
-				{
-					tmps.push_back(tri);
-				}
+				metronome::AddNavAreaSections(writer, graph, mesh, aNavData.myAreaCosts);
 			}
-
-			/* Delete duplicate edges. */
-			std::vector<bool> remove(edges.size(), false);
-			for (auto it1 = edges.begin(); it1 != edges.end(); ++it1)
+			if (shouldExportNavIslands)
 			{
-				for (auto it2 = edges.begin(); it2 != edges.end(); ++it2)
-				{
-					if (it1 == it2)
-					{
-						continue;
-					}
-					if (*it1 == *it2)
-					{
-						remove[std::distance(edges.begin(), it1)] = true;
-						remove[std::distance(edges.begin(), it2)] = true;
-					}
-				}
+				metronome::AddNavIslandSections(writer, metronome::BuildNavIslands(graph, mesh));
 			}
-
-			edges.erase(
-				std::remove_if(edges.begin(), edges.end(),
-					[&](auto const& e) { return remove[&e - &edges[0]]; }),
-				edges.end());
-
-			/* Update triangulation. */
-			for (auto const& e : edges)
+			if (shouldExportNavHierarchy)
+			{
+				metronome::AddNavClusterGraphSections(writer, metronome::BuildClusterGraph(graph, TaskGraphParallelFor));
+			}
+			if (navLandmarkCount > 0)
 			{
-				tmps.push_back({ e.p0, e.p1, {pt.x, pt.y, pt.z} });
+				metronome::AddNavLandmarkSections(writer, metronome::BuildNavLandmarks(graph, navLandmarkCount, TaskGraphParallelFor));
 			}
-			d.triangles = tmps;
-		}
-
-		/* Remove original super triangle. */
-		d.triangles.erase(
-			std::remove_if(d.triangles.begin(), d.triangles.end(),
-				[&](auto const& tri) {
-					return (
-						(tri.p0 == p0 || tri.p1 == p0 || tri.p2 == p0) ||
-						(tri.p0 == p1 || tri.p1 == p1 || tri.p2 == p1) ||
-						(tri.p0 == p2 || tri.p1 == p2 || tri.p2 == p2)
-						);
-				}),
-			d.triangles.end());
-
-		/* Add edges. */
-		for (auto const& tri : d.triangles)
+		}
+		if (!writer.Write(outPathNoExt + ".mnav"))
 		{
-			d.edges.push_back(tri.e0);
-			d.edges.push_back(tri.e1);
-			d.edges.push_back(tri.e2);
+			UE_LOG(LogExporter, Error, TEXT("Failed to write binary navmesh \"%s.mnav\""), UTF8_TO_TCHAR(outPathNoExt.c_str()))
+			succeeded = false;
 		}
-		return d;
 	}
-}
 
-#pragma endregion
-
-UExport::UExport()
-{
-	PrimaryComponentTick.bCanEverTick = true;
-}
+	if (navChunkTiles > 0)
+	{
+		if (!metronome::WriteNavChunks(outPathNoExt, metronome::SplitNavMesh(mesh, navChunkTiles), navChunkTiles, shouldCompressNavBinary))
+		{
+			UE_LOG(LogExporter, Error, TEXT("Failed to write nav chunks \"%s_*.mnav\""), UTF8_TO_TCHAR(outPathNoExt.c_str()))
+			succeeded = false;
+		}
+	}
 
-// Called every frame
-void UExport::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (shouldExportNavTiles && !ExportNavTiles(*navMesh, outPathNoExt + ".navtiles"))
+	{
+		succeeded = false;
+	}
+	return succeeded;
 }
 
-struct Face
+bool UExport::ExportNavTiles(const dtNavMesh& aNavMesh, const std::string& aOutPath)
 {
-	short x;
-	short y;
-	short z;
-};
-
-// Called when the game starts
-void UExport::BeginPlay()
-{
-	Super::BeginPlay();
-
-	UE_LOG(LogExporter, Display, TEXT("New export started!"));
+	//the blobs already hold header, polys, links, detail mesh, bv tree and off-mesh connections back to back
+	std::vector<metronome::NavTileBlob> blobs;
+	for (int i = 0; i < aNavMesh.getMaxTiles(); ++i)
+	{
+		const dtMeshTile* tile = aNavMesh.getTile(i);
+		if (tile == nullptr || tile->header == nullptr || tile->dataSize <= 0)
+		{
+			continue;
+		}
 
-	const std::string stdSceneExportName = TCHAR_TO_UTF8(*sceneExportName);
-	const std::string stdSceneExportPath = TCHAR_TO_UTF8(*sceneExportPath);
-	ExportScene(stdSceneExportPath + "/" + stdSceneExportName + ".fab");
-	ExportNavMesh(stdSceneExportPath + "/" + stdSceneExportName + "Nav.obj");
+		metronome::NavTileBlob blob;
+		blob.myTileRef = aNavMesh.getTileRef(tile);
+		blob.myData = tile->data;
+		blob.mySize = tile->dataSize;
+		blobs.push_back(blob);
+	}
 
-	UE_LOG(LogExporter, Display, TEXT("Saved export to \"%s\""), *sceneExportPath);
+	if (!metronome::WriteNavTileSet(aOutPath, aNavMesh.getParams(), sizeof(dtNavMeshParams), blobs))
+	{
+		UE_LOG(LogExporter, Error, TEXT("Failed to write nav tiles \"%s\""), UTF8_TO_TCHAR(aOutPath.c_str()))
+		return false;
+	}
+	return true;
 }
 
-void UExport::ExportNavMesh(const std::string& aOutPath)
+std::uint64_t UExport::HashNavTile(const dtMeshTile& aTile, ENavExportMode aMode, float aSimplifyTolerance)
 {
-	ARecastNavMesh* recastNavMesh = Cast<ARecastNavMesh>(FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld())->GetDefaultNavDataInstance());
-	if (recastNavMesh == nullptr)
+	//only the data the gather functions read. links are left out, detour rewrites them whenever a neighbour tile changes
+	const dtMeshHeader& header = *aTile.header;
+	std::uint64_t hash = metronome::Fnv1a64(&metronome::navTileCacheVersion, sizeof(metronome::navTileCacheVersion));
+	hash = metronome::Fnv1a64(&aMode, sizeof(aMode), hash);
+	hash = metronome::Fnv1a64(&aSimplifyTolerance, sizeof(aSimplifyTolerance), hash);
+	hash = metronome::Fnv1a64(aTile.verts, sizeof(float) * 3 * header.vertCount, hash);
+	for (int i = 0; i < header.polyCount; ++i)
 	{
-		UE_LOG(LogExporter, Warning, TEXT("No Navmesh detected, Skipping..."))
-			return;
+		const dtPoly& poly = aTile.polys[i];
+		hash = metronome::Fnv1a64(poly.verts, sizeof(poly.verts[0]) * poly.vertCount, hash);
+		hash = metronome::Fnv1a64(&poly.vertCount, sizeof(poly.vertCount), hash);
+		hash = metronome::Fnv1a64(&poly.areaAndtype, sizeof(poly.areaAndtype), hash);
+		hash = metronome::Fnv1a64(&poly.flags, sizeof(poly.flags), hash);
 	}
-	dtNavMesh* navMesh = recastNavMesh->GetRecastMesh();
-
-	TArray<FVector> vertices;
-	TArray<Face> faces;
-
-	int indiceOffset = 0;
+	hash = metronome::Fnv1a64(aTile.detailMeshes, sizeof(dtPolyDetail) * header.detailMeshCount, hash);
+	hash = metronome::Fnv1a64(aTile.detailVerts, sizeof(float) * 3 * header.detailVertCount, hash);
+	hash = metronome::Fnv1a64(aTile.detailTris, 4 * header.detailTriCount, hash);
+	return hash;
+}
 
-	for (int i = 0; i < navMesh->getMaxTiles(); ++i)
+void UExport::GatherNavTileGraph(const dtNavMesh& aNavMesh, const dtMeshTile& aTile, metronome::NavTileGraph& aGraph)
+{
+	aGraph.myIsValid = true;
+	const dtPolyRef polyRefBase = aNavMesh.getPolyRefBase(&aTile);
+	for (int i = 0; i < aTile.header->polyCount; ++i)
 	{
-		TArray<FNavPoly> polysInTile;
+		const dtPoly& poly = aTile.polys[i];
 
-		if (!recastNavMesh->GetPolysInTile(i, polysInTile))
+		FVector centroid = FVector::ZeroVector;
+		for (int j = 0; j < poly.vertCount; ++j)
 		{
-			continue;
+			centroid += Recast2UnrealPoint(&aTile.verts[poly.verts[j] * 3]);
 		}
+		centroid /= FMath::Max<int>(poly.vertCount, 1);
+		aGraph.myCentroids.push_back(ToVec3(centroid));
+		aGraph.myAreas.push_back(poly.getArea());
+		aGraph.myFlags.push_back(poly.flags);
+		aGraph.myLinkOffsets.push_back(static_cast<std::uint32_t>(aGraph.myLinkTargets.size()));
 
-		for (FNavPoly currentPoly : polysInTile)
+		for (unsigned int k = poly.firstLink; k != DT_NULL_LINK; k = aTile.links[k].next)
 		{
-			FOccluderVertexArray verts;
-			if (!recastNavMesh->GetPolyVerts(currentPoly.Ref, verts))
-			{
-				continue;
-			}
-
-			for (int j = 0; j < verts.Num(); ++j)
+			const dtLink& link = aTile.links[k];
+			unsigned int salt = 0;
+			unsigned int targetTile = 0;
+			unsigned int targetPoly = 0;
+			aNavMesh.decodePolyId(link.ref, salt, targetTile, targetPoly);
+			aGraph.myLinkTargets.push_back({ static_cast<int>(targetTile), static_cast<int>(targetPoly) });
+
+			//same portal points dtNavMeshQuery::getPortalPoints hands to the funnel
+			FVector left;
+			FVector right;
+			const dtMeshTile* linkedTile = nullptr;
+			const dtPoly* linkedPoly = nullptr;
+			aNavMesh.getTileAndPolyByRefUnsafe(link.ref, &linkedTile, &linkedPoly);
+			if (poly.getType() == DT_POLYTYPE_OFFMESH_POINT)
 			{
-				if (!vertices.Contains(verts[j]))
-					vertices.Add(verts[j]);
+				left = right = Recast2UnrealPoint(&aTile.verts[poly.verts[link.edge] * 3]);
 			}
-
-			std::vector<delaunay::Point<float>> vertexVector;
-			for (int j = 0; j < verts.Num(); ++j)
+			else if (linkedPoly->getType() == DT_POLYTYPE_OFFMESH_POINT)
 			{
-				delaunay::Point<float> point(verts[j].X, verts[j].Y, verts[j].Z);
-				vertexVector.push_back(point);
+				//off-mesh connections only store the end that touches this poly in their own links
+				left = right = centroid;
+				for (unsigned int m = linkedPoly->firstLink; m != DT_NULL_LINK; m = linkedTile->links[m].next)
+				{
+					if (linkedTile->links[m].ref == (polyRefBase | static_cast<dtPolyRef>(i)))
+					{
+						left = right = Recast2UnrealPoint(&linkedTile->verts[linkedPoly->verts[linkedTile->links[m].edge] * 3]);
+						break;
+					}
+				}
 			}
-
-			delaunay::Delaunay<float> triangles = delaunay::triangulate<float>(vertexVector);
-			for (int j = 0; j < triangles.triangles.size(); ++j)
+			else
 			{
-				Face face;
-				FVector vec0 = { triangles.triangles[j].p0.x, triangles.triangles[j].p0.y, triangles.triangles[j].p0.z };
-				FVector vec1 = { triangles.triangles[j].p1.x, triangles.triangles[j].p1.y, triangles.triangles[j].p1.z };
-				FVector vec2 = { triangles.triangles[j].p2.x, triangles.triangles[j].p2.y, triangles.triangles[j].p2.z };
-
-				face.x = FindIndex(vec0, vertices) + 1;
-				face.y = FindIndex(vec2, vertices) + 1;
-				face.z = FindIndex(vec1, vertices) + 1;
-				faces.Add(face);
+				const float* v0 = &aTile.verts[poly.verts[link.edge] * 3];
+				const float* v1 = &aTile.verts[poly.verts[(link.edge + 1) % poly.vertCount] * 3];
+				left = Recast2UnrealPoint(v0);
+				right = Recast2UnrealPoint(v1);
+				//tile border links only cover part of the edge
+				if (link.side != 0xff && (link.bmin != 0 || link.bmax != 255))
+				{
+					const FVector edgeStart = left;
+					const FVector edgeEnd = right;
+					left = FMath::Lerp(edgeStart, edgeEnd, link.bmin / 255.0f);
+					right = FMath::Lerp(edgeStart, edgeEnd, link.bmax / 255.0f);
+				}
 			}
+			aGraph.myPortals.push_back(ToVec3(left));
+			aGraph.myPortals.push_back(ToVec3(right));
 		}
 	}
+	aGraph.myLinkOffsets.push_back(static_cast<std::uint32_t>(aGraph.myLinkTargets.size()));
+
+	for (int i = 0; i < aTile.header->offMeshConCount; ++i)
+	{
+		const dtOffMeshConnection& connection = aTile.offMeshCons[i];
+		metronome::NavOffMeshLink link = {};
+		const metronome::Vec3 start = ToVec3(Recast2UnrealPoint(&connection.pos[0]));
+		const metronome::Vec3 end = ToVec3(Recast2UnrealPoint(&connection.pos[3]));
+		link.myStart[0] = start.x;
+		link.myStart[1] = start.y;
+		link.myStart[2] = start.z;
+		link.myEnd[0] = end.x;
+		link.myEnd[1] = end.y;
+		link.myEnd[2] = end.z;
+		link.myRadius = connection.rad;
+		link.myPoly = connection.poly;
+		link.myFlags = (connection.flags & DT_OFFMESH_CON_BIDIR) != 0 ? metronome::NavOffMeshLinkFlags::bidirectional : 0;
+		link.myUserId = connection.userId;
+		aGraph.myOffMeshLinks.push_back(link);
+	}
+}
 
-	std::ofstream file(aOutPath);
-	for (const FVector& vec : vertices)
+std::vector<metronome::NavAreaCost> UExport::GetAreaCosts(const ARecastNavMesh& aNavData)
+{
+	float costs[RECAST_MAX_AREAS];
+	float fixedCosts[RECAST_MAX_AREAS];
+	for (int i = 0; i < RECAST_MAX_AREAS; ++i)
+	{
+		costs[i] = 1.0f;
+		fixedCosts[i] = 0.0f;
+	}
+	if (FSharedConstNavQueryFilter filter = aNavData.GetDefaultQueryFilter())
 	{
-		FVector newVec = ToExportFVector(vec);
-		file << "v " << newVec.X << " " << newVec.Y << " " << newVec.Z << std::endl;
+		filter->GetAllAreaCosts(costs, fixedCosts, RECAST_MAX_AREAS);
 	}
 
-	for (const Face& face : faces)
+	std::vector<metronome::NavAreaCost> areaCosts(RECAST_MAX_AREAS);
+	for (int i = 0; i < RECAST_MAX_AREAS; ++i)
 	{
-		file << "f " << face.x << " " << face.y << " " << face.z << std::endl;
+		areaCosts[i] = { costs[i], fixedCosts[i] };
 	}
+	return areaCosts;
+}
+
+void UExport::GatherNavTilePolygons(const dtMeshTile& aTile, float aSimplifyTolerance, metronome::NavMeshBuilder& aBuilder)
+{
+	std::vector<metronome::NavPolygon> polygons;
+	for (int i = 0; i < aTile.header->polyCount; ++i)
+	{
+		const dtPoly& poly = aTile.polys[i];
+		if (poly.getType() != DT_POLYTYPE_GROUND)
+		{
+			continue;
+		}
 
-	file << "#VerticesCount: " << vertices.Num() << std::endl;
-	file << "#FaceCount: " << faces.Num() << std::endl;
-	file << "#IndicdeOffset: " << indiceOffset << std::endl;
+		metronome::NavPolygon polygon;
+		polygon.myPoly = i;
+		polygon.myMergeKey = static_cast<std::uint32_t>(poly.getArea()) << 16 | poly.flags;
+		for (int j = 0; j < poly.vertCount; ++j)
+		{
+			polygon.myVertices.push_back(ToVec3(Recast2UnrealPoint(&aTile.verts[poly.verts[j] * 3])));
+		}
+		polygons.push_back(std::move(polygon));
+	}
 
-	file.close();
+	if (aSimplifyTolerance > 0.0f)
+	{
+		polygons = metronome::SimplifyNavPolygons(polygons, aSimplifyTolerance);
+	}
+	for (const metronome::NavPolygon& polygon : polygons)
+	{
+		aBuilder.SetSourcePoly(polygon.myPoly);
+		aBuilder.AddPolygon(polygon.myVertices);
+	}
 }
 
-int UExport::FindIndex(const FVector& aKey, const TArray<FVector>& someVertices)
+void UExport::GatherNavTileDetailMesh(const dtMeshTile& aTile, metronome::NavMeshBuilder& aBuilder)
 {
-	for (int i = 0; i < someVertices.Num(); ++i)
+	//poly vertices are shared by every poly in the tile, so each one is only welded once per tile
+	std::vector<int> tileVertexIndices(aTile.header->vertCount, -1);
+	auto getTileVertexIndex = [&](unsigned short aTileVertex) {
+		int& index = tileVertexIndices[aTileVertex];
+		if (index == -1)
+		{
+			index = aBuilder.AddVertex(ToVec3(Recast2UnrealPoint(&aTile.verts[aTileVertex * 3])));
+		}
+		return index;
+	};
+
+	std::vector<int> detailVertexIndices;
+	for (int i = 0; i < aTile.header->polyCount; ++i)
 	{
-		if (someVertices[i] == aKey)
+		const dtPoly& poly = aTile.polys[i];
+		if (poly.getType() != DT_POLYTYPE_GROUND)
 		{
-			return i;
+			continue;
+		}
+
+		//detail vertices on poly edges are sampled by both neighbours, welding joins them
+		const dtPolyDetail& detail = aTile.detailMeshes[i];
+		aBuilder.SetSourcePoly(i);
+		detailVertexIndices.clear();
+		for (int j = 0; j < detail.vertCount; ++j)
+		{
+			detailVertexIndices.push_back(aBuilder.AddVertex(ToVec3(Recast2UnrealPoint(&aTile.detailVerts[(detail.vertBase + j) * 3]))));
+		}
+
+		//detail tris index the poly vertices first, then the poly's detail vertices
+		for (int j = 0; j < detail.triCount; ++j)
+		{
+			const unsigned char* tri = &aTile.detailTris[(detail.triBase + j) * 4];
+			int indices[3];
+			for (int k = 0; k < 3; ++k)
+			{
+				indices[k] = tri[k] < poly.vertCount
+					? getTileVertexIndex(poly.verts[tri[k]])
+					: detailVertexIndices[tri[k] - poly.vertCount];
+			}
+			aBuilder.AddTriangle(indices[0], indices[1], indices[2]);
 		}
 	}
-	return -1;
 }
 
-void UExport::ExportScene(const std::string& aOutPath)
+void UExport::SnapshotScene(metronome::SceneSnapshot& aSnapshot)
 {
 	context = ExportContext();
 
@@ -403,40 +673,54 @@ void UExport::ExportScene(const std::string& aOutPath)
 		folder->myActors.Push(actor);
 	}
 
-	nlohmann::json json;
-	json["fileVersion"] = "3.1";
-	json["root"] = CreateFolderEntity("UnrealScene", root);;
-	WriteJsonToFile(aOutPath, json);
+	SnapshotFolderEntity(aSnapshot, "UnrealScene", root, -1);
 }
 
-nlohmann::json UExport::CreateComponents(const AActor& aActor)
+bool UExport::WriteSceneFile(const std::string& aOutPath, const metronome::SceneSnapshot& aSnapshot) const
 {
-	nlohmann::json components;
-
-	//NameTag
-	components.push_back(CreateComponentJson("NameTag", CreateNameTagJson(TCHAR_TO_UTF8(ToCStr(aActor.GetActorLabel())))));
-
-	//Parent
-	components.push_back(CreateComponentJson("Parent", CreateParentJson(aActor.Children)));
+	bool succeeded = false;
+	if (sceneExportFormat == ESceneExportFormat::Mscn)
+	{
+		succeeded = metronome::WriteSceneBinary(aOutPath, aSnapshot);
+	}
+	else
+	{
+		metronome::FabWriter writer(static_cast<metronome::FabFormat>(sceneExportFormat), shouldMakeCompactJson);
+		if (writer.Open(aOutPath))
+		{
+			//on a single core splitting the scene only adds the cost of stitching it back together
+			const bool shouldWriteInParallel = FApp::ShouldUseThreadingForPerformance() && FPlatformMisc::NumberOfCoresIncludingHyperthreads() > 1;
+			metronome::WriteScene(writer, aSnapshot, shouldWriteInParallel ? metronome::ParallelForFn(TaskGraphParallelFor) : metronome::ParallelForFn());
+			succeeded = writer.Close();
+		}
+	}
+	if (!succeeded)
+	{
+		UE_LOG(LogExporter, Error, TEXT("Failed to write scene \"%s\""), UTF8_TO_TCHAR(aOutPath.c_str()))
+	}
+	return succeeded;
+}
 
+void UExport::SnapshotComponents(metronome::SceneSnapshot& aSnapshot, const AActor& aActor, std::uint32_t anEntity)
+{
 	//Transform
-	components.push_back(CreateComponentJson("Transform", CreateTransformJson(aActor.GetTransform())));
+	aSnapshot.myTransforms.push_back({ anEntity, ToTransform(aActor.GetTransform()) });
 
 	//Pointlights
 	ForeachComponent<UPointLightComponent>(aActor, [&](UPointLightComponent& aSrc){
 		CheckLight(aSrc);
-		components.push_back(CreateComponentJson("PointLight", CreatePointLightJson(aSrc)));
+		aSnapshot.myPointLights.push_back({ anEntity, ToPointLight(aSrc) });
 	});
 
 	//Spotlights
 	ForeachComponent<USpotLightComponent>(aActor, [&](USpotLightComponent& aSrc) {
 		CheckLight(aSrc);
-		components.push_back(CreateComponentJson("SpotLight", CreateSpotLightJson(aSrc)));
+		aSnapshot.mySpotLights.push_back({ anEntity, ToSpotLight(aSrc) });
 	});
 
 	//DirectionalLights
 	ForeachComponent<UDirectionalLightComponent>(aActor, [&](UDirectionalLightComponent& aSrc) {
-		components.push_back(CreateComponentJson("DirectionalLight", CreateDirectionalLightJson(aSrc)));
+		aSnapshot.myDirectionalLights.push_back({ anEntity, ToDirectionalLight(aSrc) });
 	});
 
 	//MeshRenderers
@@ -447,7 +731,7 @@ nlohmann::json UExport::CreateComponents(const AActor& aActor)
 		FString modelPath = staticMesh->AssetImportData->GetFirstFilename();
 		if (modelPath == "C:/Program Files/Epic Games/UE_4.27/Engine/Content/EditorMeshes/MatineeCam_SM.FBX") return;
 
-		nlohmann::json params;
+		metronome::MeshRenderer meshRenderer;
 
 		//process path
 		switch (ResolvePath(modelPath, "Content", "Assets"))
@@ -474,7 +758,7 @@ nlohmann::json UExport::CreateComponents(const AActor& aActor)
 				modelPath = modelFallbackPath;
 			break;
 		}
-		params["modelPath"] = TCHAR_TO_UTF8(ToCStr(modelPath));
+		meshRenderer.myModelPath = TCHAR_TO_UTF8(ToCStr(modelPath));
 
 		//process materials
 		for (const UMaterialInterface* material : aSrc.GetMaterials())
@@ -498,48 +782,36 @@ nlohmann::json UExport::CreateComponents(const AActor& aActor)
 			{
 				materialPath = materialFallbackPath;
 			}
-			params["materials"].push_back(TCHAR_TO_UTF8(ToCStr(materialPath)));
+			meshRenderer.myMaterialPaths.push_back(TCHAR_TO_UTF8(ToCStr(materialPath)));
 		}
 
-		components.push_back(CreateComponentJson("MeshRenderer", params));
+		aSnapshot.myMeshRenderers.push_back({ anEntity, std::move(meshRenderer) });
 	});
 
 	//Cameras
 	ForeachComponent<UCameraComponent>(aActor, [&](UCameraComponent& aSrc) {
-		nlohmann::json params;
-		params["fov"] = aSrc.FieldOfView;
-		params["nearPlane"] = nearPlane;
-		params["farPlane"] = farPlane;
-		components.push_back(CreateComponentJson("Camera", params));
+		metronome::Camera camera;
+		camera.myFov = aSrc.FieldOfView;
+		camera.myNearPlane = nearPlane;
+		camera.myFarPlane = farPlane;
+		aSnapshot.myCameras.push_back({ anEntity, camera });
 	});
 
 	//Box Collider
 	ForeachComponent<UBoxComponent>(aActor, [&](UBoxComponent& aSrc) {
-		nlohmann::json params;
-		params["size"] = CreateFVectorJson(ToExportFVector(aSrc.GetUnscaledBoxExtent() * 2));
-		components.push_back(CreateComponentJson("BoxCollider", params));
+		metronome::BoxCollider boxCollider;
+		boxCollider.myExtent = ToVec3(aSrc.GetUnscaledBoxExtent());
+		aSnapshot.myBoxColliders.push_back({ anEntity, boxCollider });
 
 	});
 
 	//Box Collider
 	ForeachComponent<USphereComponent>(aActor, [&](USphereComponent& aSrc) {
-		nlohmann::json params;
-		params["radius"] = aSrc.GetUnscaledSphereRadius();
-		components.push_back(CreateComponentJson("SphereCollider", params));
+		metronome::SphereCollider sphereCollider;
+		sphereCollider.myRadius = aSrc.GetUnscaledSphereRadius();
+		aSnapshot.mySphereColliders.push_back({ anEntity, sphereCollider });
 
 	});
-
-	return components;
-}
-
-nlohmann::json UExport::CreateComponentJson(const std::string& aType, const nlohmann::json& aParams)
-{
-	nlohmann::json result;
-
-	result["type"] = aType;
-	result["params"] = aParams;
-
-	return result;
 }
 
 void UExport::CheckLight(UPointLightComponent& aLight)
@@ -566,80 +838,7 @@ void UExport::CheckLight(UPointLightComponent& aLight)
 
 void UExport::WriteJsonToFile(const std::string& aPath, const nlohmann::json& aJson) const
 {
-	std::ofstream stream(aPath);
-	if (!shouldMakeCompactJson)
-	{
-		stream << std::setw(4);
-	}
-	stream << aJson;
-	stream.close();
-}
-
-nlohmann::json UExport::CreateNameTagJson(const std::string& aName)
-{
-	nlohmann::json result;
-
-	result["name"] = aName;
-
-	return result;
-}
-
-nlohmann::json UExport::CreateParentJson(const TArray<AActor*>& someChildren)
-{
-	nlohmann::json result;
-
-	for (size_t i = 0; i < someChildren.Num(); i++)
-	{
-		result["children"][i] = CreateEntity(*someChildren[i]);
-	}
-
-	return result;
-}
-
-nlohmann::json UExport::CreateTransformJson(const FTransform& aSrc)
-{
-	nlohmann::json result;
-
-	result["pos"] = CreateFVectorJson(ToExportFVector(aSrc.GetLocation() * 0.01f));
-	//result["rot"] = CreateFVectorJson(ToExportPos(aSrc.GetRotation().Euler()));
-	//result["rot"] = CreateFQuatJson(ToExportRot(aSrc.GetRotation()));
-	result["scale"] = CreateFVectorJson(ToExportFVector(aSrc.GetScale3D()).GetAbs());
-
-
-
-	{ //test
-	  //STAGE 1: get matrix data
-		FMatrix mat = FRotationMatrix::Make(aSrc.GetRotation());
-		const float m11 = mat.M[0][0];
-		const float m12 = mat.M[0][1];
-		const float m13 = mat.M[0][2];
-
-		const float m22 = mat.M[1][1];
-		const float m23 = mat.M[1][2];
-
-		const float m32 = mat.M[2][1];
-		const float m33 = mat.M[2][2];
-
-		//STAGE 2: use matrix to make euler in the xyz order
-		//https://github.com/mrdoob/three.js/blob/8ff5d832eedfd7bc698301febb60920173770899/src/math/Euler.js#L104
-		FVector xyzEuler;
-		xyzEuler.Y = asin(FMath::Clamp(m13, -1.0f, 1.0f));
-
-		if (FMath::Abs(m13) < 0.9999999f) 
-		{
-			xyzEuler.X = FMath::Atan2(-m23, m33);
-			xyzEuler.Z = FMath::Atan2(-m12, m11);
-		}
-		else 
-		{
-			xyzEuler.X = FMath::Atan2(m32, m22);
-			xyzEuler.Z = 0;
-		}
-
-		constexpr float radToDeg = 180 / 3.14159265359f;
-		result["rot"] = CreateFVectorJson(ToExportFVector(-xyzEuler * radToDeg));
-	}
-	return result;
+	metronome::WriteJsonToFile(aPath, aJson, shouldMakeCompactJson);
 }
 
 UExport::ResolvePathResult UExport::ResolvePath(FString& aPath, const FString& aIncorrectPathPrefix, const FString& aCorrectPathPrefix)
@@ -669,173 +868,93 @@ void UExport::EnsureMaterial(const FString& aPath)
 
 void UExport::EnsureFolder(const FString& aPath)
 {
-	CreateDirectory(ToCStr(aPath), NULL);
+	IFileManager::Get().MakeDirectory(ToCStr(aPath), true);
 }
 
-nlohmann::json UExport::CreateLightJson(const ULightComponent& aSrc)
+void UExport::SnapshotEntity(metronome::SceneSnapshot& aSnapshot, const AActor& aActor, std::int32_t aParent)
 {
-	nlohmann::json result;
-
-	result["color"] = CreateColorJson(aSrc.GetLightColor());
-	result["intensity"] = aSrc.Intensity;
-
-	return result;
+	const std::uint32_t entity = static_cast<std::uint32_t>(aSnapshot.myEntities.size());
+	aSnapshot.myEntities.push_back({ TCHAR_TO_UTF8(ToCStr(aActor.GetActorLabel())), aParent, false });
+	//components before children, the snapshot's tables are sorted by entity
+	SnapshotComponents(aSnapshot, aActor, entity);
+	for (AActor* child : aActor.Children)
+	{
+		SnapshotEntity(aSnapshot, *child, static_cast<std::int32_t>(entity));
+	}
 }
 
-nlohmann::json UExport::CreatePointLightJson(const UPointLightComponent& aSrc)
-{
-	nlohmann::json result = CreateLightJson(aSrc);
-
-	result["range"] = aSrc.AttenuationRadius * 0.01f;
-
-	return result;
+void UExport::SnapshotFolderEntity(metronome::SceneSnapshot& aSnapshot, const std::string& aName, const Folder& aFolder, std::int32_t aParent) {
+	const std::int32_t entity = static_cast<std::int32_t>(aSnapshot.myEntities.size());
+	aSnapshot.myEntities.push_back({ aName, aParent, true });
+	for (const std::pair<const std::string, Folder>& pair : aFolder.mySubFolders)
+	{
+		SnapshotFolderEntity(aSnapshot, pair.first, pair.second, entity);
+	}
+	for (AActor* actor : aFolder.myActors)
+	{
+		SnapshotEntity(aSnapshot, *actor, entity);
+	}
 }
 
-nlohmann::json UExport::CreateSpotLightJson(const USpotLightComponent& aSrc)
+metronome::Vec3 UExport::ToVec3(const FVector& aSrc)
 {
-	nlohmann::json result = CreatePointLightJson(aSrc);
-
-	result["innerRadius"] = aSrc.InnerConeAngle;
-	result["outerRadius"] = aSrc.OuterConeAngle;
-
-	return result;
+	return { aSrc.X, aSrc.Y, aSrc.Z };
 }
 
-nlohmann::json UExport::CreateDirectionalLightJson(const UDirectionalLightComponent& aSrc)
+metronome::Quat UExport::ToQuat(const FQuat& aSrc)
 {
-	nlohmann::json result = CreateLightJson(aSrc);
-
-	//no actions needed
-
-	return result;
+	return { aSrc.X, aSrc.Y, aSrc.Z, aSrc.W };
 }
 
-nlohmann::json UExport::CreateEntity(const AActor& aActor)
+metronome::Color UExport::ToColor(const FLinearColor& aSrc)
 {
-	nlohmann::json entity;
-
-	entity["components"] = CreateComponents(aActor);
-
-	return entity;
+	return { aSrc.R, aSrc.G, aSrc.B, aSrc.A };
 }
 
-nlohmann::json UExport::CreateFolderEntity(const std::string& aName, const Folder& aFolder) {
-	nlohmann::json entity;
-	nlohmann::json& components = entity["components"];
+metronome::Transform UExport::ToTransform(const FTransform& aSrc)
+{
+	metronome::Transform result;
 
-	components.push_back(CreateComponentJson("NameTag", CreateNameTagJson(aName + " [FOLDER]")));
-	nlohmann::json parent = CreateComponentJson("Parent", CreateParentJson(aFolder.myActors));
-	nlohmann::json children; //we use this to force the folders to the top of the hierarchy
-	for (std::pair<const std::string, Folder> pair : aFolder.mySubFolders)
-	{
-		children.push_back(CreateFolderEntity(pair.first, pair.second));
-	}
-	for (nlohmann::json& child: parent["params"]["children"])
-	{
-		children.push_back(child);
-	}
-	parent["params"]["children"] = children;
-	components.push_back(parent);
+	result.myLocation = ToVec3(aSrc.GetLocation());
+	result.myRotation = ToQuat(aSrc.GetRotation());
+	result.myScale = ToVec3(aSrc.GetScale3D());
 
-	return entity;
+	return result;
 }
 
-nlohmann::json UExport::CreateFVectorJson(const FVector& aSrc)
-{
-	return {
-		{"x", aSrc.X},
-		{"y", aSrc.Y},
-		{"z", aSrc.Z}
-	};
-}
-nlohmann::json UExport::CreateFQuatJson(const FQuat& aSrc)
-{
-	return {
-		{"x", aSrc.X},
-		{"y", aSrc.Y},
-		{"z", aSrc.Z},
-		{"w", aSrc.W}
-	};
-}
-nlohmann::json UExport::CreateColorJson(const FLinearColor& aSrc)
+void UExport::ToLight(const ULightComponent& aSrc, metronome::Light& aResult)
 {
-	return {
-		{"r", aSrc.R},
-		{"g", aSrc.G},
-		{"b", aSrc.B},
-		{"a", aSrc.A}
-	};
+	aResult.myColor = ToColor(aSrc.GetLightColor());
+	aResult.myIntensity = aSrc.Intensity;
 }
 
-FVector UExport::ToExportFVector(const FVector& aSrc)
+metronome::PointLight UExport::ToPointLight(const UPointLightComponent& aSrc)
 {
-	FVector result;
+	metronome::PointLight result;
 
-	result.X = aSrc.Y;
-	result.Y = aSrc.Z;
-	result.Z = aSrc.X;
+	ToLight(aSrc, result);
+	result.myAttenuationRadius = aSrc.AttenuationRadius;
 
 	return result;
 }
-FQuat UExport::ToExportFQuat(const FQuat& aSrc)
-{
-	//STAGE 1: get matrix data
-	FMatrix mat = FRotationMatrix::Make(aSrc);
-	const float m11 = mat.M[0][0];
-	const float m12 = mat.M[0][1];
-	const float m13 = mat.M[0][2];
-
-	const float m22 = mat.M[1][1];
-	const float m23 = mat.M[1][2];
-
-	const float m32 = mat.M[2][1];
-	const float m33 = mat.M[2][2];
-
-	//STAGE 2: use matrix to make euler in the xyz order
-	//https://github.com/mrdoob/three.js/blob/8ff5d832eedfd7bc698301febb60920173770899/src/math/Euler.js#L104
-	FVector xyzEuler;
-	xyzEuler.Y = asin(FMath::Clamp(m13, -1.0f, 1.0f));
 
-	if (FMath::Abs(m13) < 0.9999999f) 
-	{
-		xyzEuler.X = FMath::Atan2(-m23, m33);
-		xyzEuler.Z = FMath::Atan2(-m12, m11);
-	}
-	else 
-	{
-		xyzEuler.X = FMath::Atan2(m32, m22);
-		xyzEuler.Z = 0;
-	}
-
-
-	//STAGE 3: make quaternion in xyz order using new xyz euler
-	//https://github.com/mrdoob/three.js/blob/61a4d5c90034e904d77f2787ee11dc512e51968d/src/math/Quaternion.js#L206
-	const float c1 = cos(xyzEuler.X / 2);
-	const float c2 = cos(xyzEuler.Y / 2);
-	const float c3 = cos(xyzEuler.Z / 2);
+metronome::SpotLight UExport::ToSpotLight(const USpotLightComponent& aSrc)
+{
+	metronome::SpotLight result;
 
-	const float s1 = sin(xyzEuler.X / 2);
-	const float s2 = sin(xyzEuler.Y / 2);
-	const float s3 = sin(xyzEuler.Z / 2);
+	ToLight(aSrc, result);
+	result.myAttenuationRadius = aSrc.AttenuationRadius;
+	result.myInnerConeAngle = aSrc.InnerConeAngle;
+	result.myOuterConeAngle = aSrc.OuterConeAngle;
 
-	FQuat xyzQuat;
-	xyzQuat.X = s1 * c2 * c3 + c1 * s2 * s3;
-	xyzQuat.Y = c1 * s2 * c3 - s1 * c2 * s3;
-	xyzQuat.Z = c1 * c2 * s3 + s1 * s2 * c3;
-	xyzQuat.W = c1 * c2 * c3 - s1 * s2 * s3;
+	return result;
+}
 
-	//STAGE 4: swizzle xyzQuat into the right component layout for metronome
-	FQuat result;
-	result.X = xyzQuat.Y;
-	result.Y = xyzQuat.Z;
-	result.Z = xyzQuat.X;
-	result.W = -xyzQuat.W;
+metronome::DirectionalLight UExport::ToDirectionalLight(const UDirectionalLightComponent& aSrc)
+{
+	metronome::DirectionalLight result;
 
-	//result.X = aRot.Y;
-	//result.Y = aRot.Z;
-	//result.Z = aRot.X;
-	//result.W = aRot.W;
-	//result.Normalize(); //we shouldn't need this but better safe than sorry
+	ToLight(aSrc, result);
 
 	return result;
 }
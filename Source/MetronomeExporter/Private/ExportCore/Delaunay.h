@@ -0,0 +1,692 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DELAUNAY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define DELAUNAY_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DELAUNAY_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DELAUNAY_TARGET_AVX2
+#endif
+
+namespace delaunay
+{
+	constexpr double eps = 1e-4;
+
+	template <typename T>
+	struct Point
+	{
+		T x, y, z;
+
+		Point() : x{ 0 }, y{ 0 }, z{ 0 } {}
+		Point(T _x, T _y, T _z) : x{ _x }, y{ _y }, z{ _z } {}
+
+		template <typename U>
+		Point(U _x, U _y, U _z) : x{ static_cast<T>(_x) }, y{ static_cast<T>(_y) }, z{ static_cast<T>(_z) }
+		{
+		}
+
+		friend std::ostream& operator<<(std::ostream& os, const Point<T>& p)
+		{
+			os << "x=" << p.x << "  y=" << p.y;
+			return os;
+		}
+
+		bool operator==(const Point<T>& other) const
+		{
+			return (other.x == x && other.y == y);
+		}
+
+		bool operator!=(const Point<T>& other) const { return !operator==(other); }
+	};
+
+	template <typename T>
+	struct Edge
+	{
+		using Node = Point<T>;
+		Node p0, p1;
+
+		Edge(Node const& _p0, Node const& _p1) : p0{ _p0 }, p1{ _p1 } {}
+
+		friend std::ostream& operator<<(std::ostream& os, const Edge& e)
+		{
+			os << "p0: [" << e.p0 << " ] p1: [" << e.p1 << "]";
+			return os;
+		}
+
+		bool operator==(const Edge& other) const
+		{
+			return ((other.p0 == p0 && other.p1 == p1) ||
+				(other.p0 == p1 && other.p1 == p0));
+		}
+	};
+
+	template <typename T>
+	struct Circle
+	{
+		T x, y, radius;
+		Circle() = default;
+	};
+
+	template <typename T>
+	struct Triangle
+	{
+		using Node = Point<T>;
+		Node p0, p1, p2;
+		Edge<T> e0, e1, e2;
+		Circle<T> circle;
+
+		Triangle(const Node& _p0, const Node& _p1, const Node& _p2)
+			: p0{ _p0 },
+			p1{ _p1 },
+			p2{ _p2 },
+			e0{ _p0, _p1 },
+			e1{ _p1, _p2 },
+			e2{ _p0, _p2 },
+			circle{}
+		{
+			const auto ax = p1.x - p0.x;
+			const auto ay = p1.y - p0.y;
+			const auto bx = p2.x - p0.x;
+			const auto by = p2.y - p0.y;
+
+			const auto m = p1.x * p1.x - p0.x * p0.x + p1.y * p1.y - p0.y * p0.y;
+			const auto u = p2.x * p2.x - p0.x * p0.x + p2.y * p2.y - p0.y * p0.y;
+			const auto s = 1. / (2. * (ax * by - ay * bx));
+
+			circle.x = ((p2.y - p0.y) * m + (p0.y - p1.y) * u) * s;
+			circle.y = ((p0.x - p2.x) * m + (p1.x - p0.x) * u) * s;
+
+			const auto dx = p0.x - circle.x;
+			const auto dy = p0.y - circle.y;
+			circle.radius = dx * dx + dy * dy;
+		}
+	};
+
+	template <typename T>
+	struct Delaunay
+	{
+		std::vector<Triangle<T>> triangles;
+		std::vector<Edge<T>> edges;
+		std::vector<std::array<int, 3>> indices; /* Input point indices of each triangle. */
+	};
+
+	namespace simd
+	{
+		/* Circumcircles of the live triangles as a structure of arrays, the in-circle kernels only touch these. */
+		struct CircleStore
+		{
+			std::vector<double> x, y, radius;
+
+			void reserve(std::size_t n)
+			{
+				x.reserve(n);
+				y.reserve(n);
+				radius.reserve(n);
+			}
+
+			void grow()
+			{
+				x.push_back(0);
+				y.push_back(0);
+				radius.push_back(0);
+			}
+		};
+
+		/* Writes 1 to inside[i] when (px, py) lies in the circumcircle of triangle ids[i]. */
+		using InCircleBatchFn = void (*)(const CircleStore& circles, const int* ids, int count, double px, double py, unsigned char* inside);
+
+		inline void in_circle_batch_scalar(const CircleStore& circles, const int* ids, int count, double px, double py, unsigned char* inside)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				const int id = ids[i];
+				const double dx = circles.x[id] - px;
+				const double dy = circles.y[id] - py;
+				inside[i] = (dx * dx + dy * dy - circles.radius[id]) <= eps;
+			}
+		}
+
+#if defined(DELAUNAY_X86)
+		inline void in_circle_batch_sse2(const CircleStore& circles, const int* ids, int count, double px, double py, unsigned char* inside)
+		{
+			const double* cx = circles.x.data();
+			const double* cy = circles.y.data();
+			const double* cr = circles.radius.data();
+			const __m128d vpx = _mm_set1_pd(px);
+			const __m128d vpy = _mm_set1_pd(py);
+			const __m128d veps = _mm_set1_pd(eps);
+
+			int i = 0;
+			for (; i + 2 <= count; i += 2)
+			{
+				const int a = ids[i], b = ids[i + 1];
+				const __m128d dx = _mm_sub_pd(_mm_set_pd(cx[b], cx[a]), vpx);
+				const __m128d dy = _mm_sub_pd(_mm_set_pd(cy[b], cy[a]), vpy);
+				const __m128d dist = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+				const int mask = _mm_movemask_pd(_mm_cmple_pd(_mm_sub_pd(dist, _mm_set_pd(cr[b], cr[a])), veps));
+				inside[i] = mask & 1;
+				inside[i + 1] = (mask >> 1) & 1;
+			}
+			in_circle_batch_scalar(circles, ids + i, count - i, px, py, inside + i);
+		}
+
+		DELAUNAY_TARGET_AVX2 inline void in_circle_batch_avx2(const CircleStore& circles, const int* ids, int count, double px, double py, unsigned char* inside)
+		{
+			const __m256d vpx = _mm256_set1_pd(px);
+			const __m256d vpy = _mm256_set1_pd(py);
+			const __m256d veps = _mm256_set1_pd(eps);
+			const __m256d zero = _mm256_setzero_pd();
+			const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+			int i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ids + i));
+				const __m256d dx = _mm256_sub_pd(_mm256_mask_i32gather_pd(zero, circles.x.data(), idx, all, 8), vpx);
+				const __m256d dy = _mm256_sub_pd(_mm256_mask_i32gather_pd(zero, circles.y.data(), idx, all, 8), vpy);
+				const __m256d r = _mm256_mask_i32gather_pd(zero, circles.radius.data(), idx, all, 8);
+				const __m256d dist = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+				const int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_sub_pd(dist, r), veps, _CMP_LE_OQ));
+				inside[i] = mask & 1;
+				inside[i + 1] = (mask >> 1) & 1;
+				inside[i + 2] = (mask >> 2) & 1;
+				inside[i + 3] = (mask >> 3) & 1;
+			}
+			in_circle_batch_sse2(circles, ids + i, count - i, px, py, inside + i);
+		}
+
+		inline bool cpu_has_avx2()
+		{
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+			{
+				return false;
+			}
+			__cpuid(info, 1);
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+			{
+				return false;
+			}
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#else
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+#elif defined(DELAUNAY_NEON)
+		inline void in_circle_batch_neon(const CircleStore& circles, const int* ids, int count, double px, double py, unsigned char* inside)
+		{
+			const double* cx = circles.x.data();
+			const double* cy = circles.y.data();
+			const double* cr = circles.radius.data();
+			const float64x2_t vpx = vdupq_n_f64(px);
+			const float64x2_t vpy = vdupq_n_f64(py);
+			const float64x2_t veps = vdupq_n_f64(eps);
+
+			int i = 0;
+			for (; i + 2 <= count; i += 2)
+			{
+				const int a = ids[i], b = ids[i + 1];
+				const float64x2_t dx = vsubq_f64(vsetq_lane_f64(cx[b], vdupq_n_f64(cx[a]), 1), vpx);
+				const float64x2_t dy = vsubq_f64(vsetq_lane_f64(cy[b], vdupq_n_f64(cy[a]), 1), vpy);
+				const float64x2_t r = vsetq_lane_f64(cr[b], vdupq_n_f64(cr[a]), 1);
+				const float64x2_t dist = vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy));
+				const uint64x2_t le = vcleq_f64(vsubq_f64(dist, r), veps);
+				inside[i] = vgetq_lane_u64(le, 0) != 0;
+				inside[i + 1] = vgetq_lane_u64(le, 1) != 0;
+			}
+			in_circle_batch_scalar(circles, ids + i, count - i, px, py, inside + i);
+		}
+#endif
+
+		inline InCircleBatchFn select_in_circle_batch()
+		{
+#if defined(DELAUNAY_X86)
+			return cpu_has_avx2() ? in_circle_batch_avx2 : in_circle_batch_sse2;
+#elif defined(DELAUNAY_NEON)
+			return in_circle_batch_neon;
+#else
+			return in_circle_batch_scalar;
+#endif
+		}
+
+		/* Kernel picked once for the running cpu. */
+		inline InCircleBatchFn in_circle_batch()
+		{
+			static const InCircleBatchFn fn = select_in_circle_batch();
+			return fn;
+		}
+	}
+
+	namespace detail
+	{
+		constexpr int none = -1;
+
+		struct Tri
+		{
+			int v[3]; //counter-clockwise
+			int n[3]; //n[i] is the neighbour across the edge opposite v[i]
+		};
+
+		struct BoundaryEdge
+		{
+			int a, b;
+			int outer, outerEdge;
+		};
+
+		inline double orient(double ax, double ay, double bx, double by, double cx, double cy)
+		{
+			return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+		}
+
+		inline std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y)
+		{
+			constexpr std::uint32_t n = 1u << 16;
+			std::uint64_t d = 0;
+			for (std::uint32_t s = n / 2; s > 0; s /= 2)
+			{
+				const std::uint32_t rx = (x & s) > 0;
+				const std::uint32_t ry = (y & s) > 0;
+				d += static_cast<std::uint64_t>(s) * s * ((3 * rx) ^ ry);
+				if (ry == 0)
+				{
+					if (rx == 1)
+					{
+						x = n - 1 - x;
+						y = n - 1 - y;
+					}
+					std::swap(x, y);
+				}
+			}
+			return d;
+		}
+
+		/* Biased randomized insertion order: random rounds of doubling size, each round sorted along a hilbert curve. */
+		inline std::vector<int> brio_order(const std::vector<double>& xs, const std::vector<double>& ys, int count)
+		{
+			std::vector<int> order(count);
+			std::iota(order.begin(), order.end(), 0);
+
+			/* A single round is fully sorted below, only larger sets need the random rounds. */
+			constexpr int smallestRound = 32;
+			if (count > smallestRound)
+			{
+				//portable fisher-yates so every platform inserts in the same order
+				std::mt19937 rng(0x4d455452u);
+				for (int i = count - 1; i > 0; --i)
+				{
+					std::swap(order[i], order[rng() % static_cast<std::uint32_t>(i + 1)]);
+				}
+			}
+
+			double xmin = xs[0], xmax = xs[0], ymin = ys[0], ymax = ys[0];
+			for (int i = 1; i < count; ++i)
+			{
+				xmin = std::min(xmin, xs[i]);
+				xmax = std::max(xmax, xs[i]);
+				ymin = std::min(ymin, ys[i]);
+				ymax = std::max(ymax, ys[i]);
+			}
+			const double scale = 65535. / std::max({ xmax - xmin, ymax - ymin, eps });
+
+			std::vector<std::uint64_t> keys(count);
+			for (int i = 0; i < count; ++i)
+			{
+				keys[i] = hilbert_index(
+					static_cast<std::uint32_t>((xs[i] - xmin) * scale),
+					static_cast<std::uint32_t>((ys[i] - ymin) * scale));
+			}
+
+			int end = count;
+			while (end > 0)
+			{
+				const int begin = end > smallestRound ? end / 2 : 0;
+				std::sort(order.begin() + begin, order.begin() + end, [&](int a, int b) { return keys[a] < keys[b]; });
+				end = begin;
+			}
+			return order;
+		}
+
+		/* Incremental Bowyer-Watson over an adjacency graph, the cavity of each insertion is found by flooding from the located triangle. */
+		class Triangulator
+		{
+		public:
+			Triangulator(std::vector<double> xs, std::vector<double> ys, int count)
+				: xs_(std::move(xs)), ys_(std::move(ys)), count_(count), slot_(count + 3, none)
+			{
+				double xmin = xs_[0], xmax = xs_[0], ymin = ys_[0], ymax = ys_[0];
+				for (int i = 1; i < count_; ++i)
+				{
+					xmin = std::min(xmin, xs_[i]);
+					xmax = std::max(xmax, xs_[i]);
+					ymin = std::min(ymin, ys_[i]);
+					ymax = std::max(ymax, ys_[i]);
+				}
+				const double dmax = std::max(xmax - xmin, ymax - ymin);
+				const double midx = (xmin + xmax) / 2.;
+				const double midy = (ymin + ymax) / 2.;
+
+				/* Super triangle, appended after the real points. */
+				xs_.resize(count_ + 3);
+				ys_.resize(count_ + 3);
+				xs_[count_ + 0] = midx - 20 * dmax;
+				ys_[count_ + 0] = midy - dmax;
+				xs_[count_ + 1] = midx + 20 * dmax;
+				ys_[count_ + 1] = midy - dmax;
+				xs_[count_ + 2] = midx;
+				ys_[count_ + 2] = midy + 20 * dmax;
+
+				tris_.reserve(2 * count_ + 1);
+				circles_.reserve(2 * count_ + 1);
+				tris_.push_back({ { count_ + 0, count_ + 1, count_ + 2 }, { none, none, none } });
+				circles_.grow();
+				update_circle(0);
+				mark_.push_back(0);
+			}
+
+			void insert(int p)
+			{
+				const double px = xs_[p];
+				const double py = ys_[p];
+				const int start = locate(px, py);
+
+				for (int v : tris_[start].v)
+				{
+					const double dx = xs_[v] - px;
+					const double dy = ys_[v] - py;
+					if (dx * dx + dy * dy <= eps * eps)
+					{
+						return; /* Duplicate point. */
+					}
+				}
+
+				stamp_ += 3;
+				const unsigned in = stamp_, out = stamp_ + 1, pending = stamp_ + 2;
+
+				/* Flood the cavity of triangles whose circumcircle contains p, one frontier at a time so each frontier is tested in a single batch. */
+				cavity_.clear();
+				cavity_.push_back(start);
+				mark_[start] = in;
+				for (std::size_t waveBegin = 0; waveBegin < cavity_.size();)
+				{
+					const std::size_t waveEnd = cavity_.size();
+					frontier_.clear();
+					for (std::size_t i = waveBegin; i < waveEnd; ++i)
+					{
+						for (int nb : tris_[cavity_[i]].n)
+						{
+							if (nb != none && mark_[nb] != in && mark_[nb] != out)
+							{
+								mark_[nb] = out;
+								frontier_.push_back(nb);
+							}
+						}
+					}
+					inside_.resize(frontier_.size());
+					simd::in_circle_batch()(circles_, frontier_.data(), static_cast<int>(frontier_.size()), px, py, inside_.data());
+					for (std::size_t i = 0; i < frontier_.size(); ++i)
+					{
+						if (inside_[i])
+						{
+							mark_[frontier_[i]] = in;
+							cavity_.push_back(frontier_[i]);
+						}
+					}
+					waveBegin = waveEnd;
+				}
+
+				/* Rounding can make the cavity non star-shaped, shrink it until p sees every boundary edge. */
+				while (!collect_boundary(start, p, in, out))
+				{
+					for (int t : cavity_)
+					{
+						if (mark_[t] == in)
+						{
+							mark_[t] = pending;
+						}
+					}
+					cavity_.clear();
+					cavity_.push_back(start);
+					mark_[start] = in;
+					for (std::size_t i = 0; i < cavity_.size(); ++i)
+					{
+						for (int nb : tris_[cavity_[i]].n)
+						{
+							if (nb != none && mark_[nb] == pending)
+							{
+								mark_[nb] = in;
+								cavity_.push_back(nb);
+							}
+						}
+					}
+				}
+
+				/* Fan the cavity boundary around p, reusing the cavity slots in place. */
+				created_.clear();
+				for (std::size_t i = 0; i < boundary_.size(); ++i)
+				{
+					const BoundaryEdge& e = boundary_[i];
+					int id;
+					if (i < cavity_.size())
+					{
+						id = cavity_[i];
+					}
+					else
+					{
+						id = static_cast<int>(tris_.size());
+						tris_.emplace_back();
+						circles_.grow();
+						mark_.push_back(0);
+					}
+					tris_[id] = { { p, e.a, e.b }, { e.outer, none, none } };
+					if (e.outer != none)
+					{
+						tris_[e.outer].n[e.outerEdge] = id;
+					}
+					update_circle(id);
+					slot_[e.a] = static_cast<int>(i);
+					created_.push_back(id);
+				}
+				for (std::size_t i = 0; i < boundary_.size(); ++i)
+				{
+					const int next = created_[slot_[boundary_[i].b]];
+					tris_[created_[i]].n[1] = next;
+					tris_[next].n[2] = created_[i];
+				}
+				last_ = created_.front();
+			}
+
+			template <typename T>
+			void collect(const std::vector<Point<T>>& points, Delaunay<T>& d) const
+			{
+				for (const Tri& tri : tris_)
+				{
+					if (tri.v[0] >= count_ || tri.v[1] >= count_ || tri.v[2] >= count_)
+					{
+						continue; /* Touches the super triangle. */
+					}
+					d.triangles.emplace_back(points[tri.v[0]], points[tri.v[1]], points[tri.v[2]]);
+					d.indices.push_back({ tri.v[0], tri.v[1], tri.v[2] });
+				}
+			}
+
+		private:
+			double orient(int a, int b, double px, double py) const
+			{
+				return detail::orient(xs_[a], ys_[a], xs_[b], ys_[b], px, py);
+			}
+
+			void update_circle(int t)
+			{
+				const int* v = tris_[t].v;
+				const double ax = xs_[v[1]] - xs_[v[0]];
+				const double ay = ys_[v[1]] - ys_[v[0]];
+				const double bx = xs_[v[2]] - xs_[v[0]];
+				const double by = ys_[v[2]] - ys_[v[0]];
+				const double m = ax * ax + ay * ay;
+				const double u = bx * bx + by * by;
+				const double s = 1. / (2. * (ax * by - ay * bx));
+
+				const double cx = (by * m - ay * u) * s;
+				const double cy = (ax * u - bx * m) * s;
+				circles_.x[t] = xs_[v[0]] + cx;
+				circles_.y[t] = ys_[v[0]] + cy;
+				circles_.radius[t] = cx * cx + cy * cy;
+			}
+
+			/* Visibility walk from the last created triangle. */
+			int locate(double px, double py) const
+			{
+				int t = last_;
+				for (std::size_t steps = 0; steps <= tris_.size(); ++steps)
+				{
+					const Tri& tri = tris_[t];
+					int next = none;
+					for (int k = 0; k < 3; ++k)
+					{
+						const int e = (k + static_cast<int>(steps)) % 3;
+						if (orient(tri.v[(e + 1) % 3], tri.v[(e + 2) % 3], px, py) < 0 && tri.n[e] != none)
+						{
+							next = tri.n[e];
+							break;
+						}
+					}
+					if (next == none)
+					{
+						return t;
+					}
+					t = next;
+				}
+
+				/* The walk cycled on near-degenerate input, pick the triangle p is least outside of. */
+				int best = 0;
+				double bestScore = -std::numeric_limits<double>::infinity();
+				for (std::size_t i = 0; i < tris_.size(); ++i)
+				{
+					const Tri& tri = tris_[i];
+					const double score = std::min({
+						orient(tri.v[1], tri.v[2], px, py),
+						orient(tri.v[2], tri.v[0], px, py),
+						orient(tri.v[0], tri.v[1], px, py) });
+					if (score > bestScore)
+					{
+						bestScore = score;
+						best = static_cast<int>(i);
+					}
+				}
+				return best;
+			}
+
+			bool collect_boundary(int start, int p, unsigned in, unsigned out)
+			{
+				boundary_.clear();
+				for (int t : cavity_)
+				{
+					const Tri& tri = tris_[t];
+					for (int k = 0; k < 3; ++k)
+					{
+						const int nb = tri.n[k];
+						if (nb != none && mark_[nb] == in)
+						{
+							continue;
+						}
+						const int a = tri.v[(k + 1) % 3];
+						const int b = tri.v[(k + 2) % 3];
+						if (t != start && orient(a, b, xs_[p], ys_[p]) <= 0)
+						{
+							mark_[t] = out;
+							return false;
+						}
+						int outerEdge = 0;
+						if (nb != none)
+						{
+							while (tris_[nb].n[outerEdge] != t)
+							{
+								++outerEdge;
+							}
+						}
+						boundary_.push_back({ a, b, nb, outerEdge });
+					}
+				}
+				return true;
+			}
+
+			std::vector<double> xs_, ys_;
+			int count_;
+			std::vector<Tri> tris_;
+			simd::CircleStore circles_;
+			std::vector<unsigned> mark_;
+			unsigned stamp_ = 0;
+			int last_ = 0;
+
+			std::vector<int> cavity_;
+			std::vector<int> frontier_;
+			std::vector<unsigned char> inside_;
+			std::vector<BoundaryEdge> boundary_;
+			std::vector<int> created_;
+			std::vector<int> slot_;
+		};
+	}
+
+	template <
+		typename T,
+		typename = typename std::enable_if<std::is_floating_point<T>::value>::type>
+		Delaunay<T> triangulate(const std::vector<Point<T>>& points)
+	{
+		if (points.size() < 3)
+		{
+			return Delaunay<T>{};
+		}
+
+		const int count = static_cast<int>(points.size());
+		std::vector<double> xs(count), ys(count);
+		for (int i = 0; i < count; ++i)
+		{
+			xs[i] = points[i].x;
+			ys[i] = points[i].y;
+		}
+
+		/* Init Delaunay triangulation. */
+		auto d = Delaunay<T>{};
+		const std::vector<int> order = detail::brio_order(xs, ys, count);
+		detail::Triangulator triangulator(std::move(xs), std::move(ys), count);
+		for (int p : order)
+		{
+			triangulator.insert(p);
+		}
+		triangulator.collect(points, d);
+
+		/* Add edges. */
+		for (auto const& tri : d.triangles)
+		{
+			d.edges.push_back(tri.e0);
+			d.edges.push_back(tri.e1);
+			d.edges.push_back(tri.e2);
+		}
+		return d;
+	}
+}
@@ -0,0 +1,144 @@
+#include "ExportMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace metronome
+{
+	Vec3 Abs(const Vec3& aSrc)
+	{
+		return { std::abs(aSrc.x), std::abs(aSrc.y), std::abs(aSrc.z) };
+	}
+
+	Vec3 ToExportVector(const Vec3& aSrc)
+	{
+		Vec3 result;
+
+		result.x = aSrc.y;
+		result.y = aSrc.z;
+		result.z = aSrc.x;
+
+		return result;
+	}
+
+	//FMath::Atan2 from UE4.27, a minimax approximation rather than atan2f. kept so the exported angles match the
+	//engine side export bit for bit
+	static float Atan2(float aY, float aX)
+	{
+		constexpr float pi = 3.1415926535897932f;
+		const float absX = std::abs(aX);
+		const float absY = std::abs(aY);
+		const bool isYAbsBigger = absY > absX;
+		float t0 = isYAbsBigger ? absY : absX;
+		const float t1 = isYAbsBigger ? absX : absY;
+		if (t0 == 0.0f)
+		{
+			return 0.0f;
+		}
+
+		float t3 = t1 / t0;
+		const float t4 = t3 * t3;
+		static const float c[7] = {
+			+7.2128853633444123e-03f,
+			-3.5059680836411644e-02f,
+			+8.1675882859940430e-02f,
+			-1.3374657325451267e-01f,
+			+1.9856563505717162e-01f,
+			-3.3324998579202170e-01f,
+			+1.0f
+		};
+		t0 = c[0];
+		t0 = t0 * t4 + c[1];
+		t0 = t0 * t4 + c[2];
+		t0 = t0 * t4 + c[3];
+		t0 = t0 * t4 + c[4];
+		t0 = t0 * t4 + c[5];
+		t0 = t0 * t4 + c[6];
+		t3 = t0 * t3;
+
+		t3 = isYAbsBigger ? 0.5f * pi - t3 : t3;
+		t3 = aX < 0.0f ? pi - t3 : t3;
+		t3 = aY < 0.0f ? -t3 : t3;
+		return t3;
+	}
+
+	Vec3 ToXyzEuler(const Quat& aSrc)
+	{
+		//STAGE 1: get matrix data (same layout as FRotationMatrix::Make)
+		const float x2 = aSrc.x + aSrc.x;
+		const float y2 = aSrc.y + aSrc.y;
+		const float z2 = aSrc.z + aSrc.z;
+		const float xx = aSrc.x * x2;
+		const float xy = aSrc.x * y2;
+		const float xz = aSrc.x * z2;
+		const float yy = aSrc.y * y2;
+		const float yz = aSrc.y * z2;
+		const float zz = aSrc.z * z2;
+		const float wx = aSrc.w * x2;
+		const float wy = aSrc.w * y2;
+		const float wz = aSrc.w * z2;
+
+		const float m11 = 1.0f - (yy + zz);
+		const float m12 = xy + wz;
+		const float m13 = xz - wy;
+
+		const float m22 = 1.0f - (xx + zz);
+		const float m23 = yz + wx;
+
+		const float m32 = yz - wx;
+		const float m33 = 1.0f - (xx + yy);
+
+		//STAGE 2: use matrix to make euler in the xyz order
+		//https://github.com/mrdoob/three.js/blob/8ff5d832eedfd7bc698301febb60920173770899/src/math/Euler.js#L104
+		Vec3 xyzEuler;
+		xyzEuler.y = std::asin(std::clamp(m13, -1.0f, 1.0f));
+
+		if (std::abs(m13) < 0.9999999f)
+		{
+			xyzEuler.x = Atan2(-m23, m33);
+			xyzEuler.z = Atan2(-m12, m11);
+		}
+		else
+		{
+			xyzEuler.x = Atan2(m32, m22);
+			xyzEuler.z = 0;
+		}
+
+		return xyzEuler;
+	}
+
+	Vec3 ToExportEuler(const Quat& aSrc)
+	{
+		constexpr float radToDeg = 180 / 3.14159265359f;
+		return ToExportVector(-ToXyzEuler(aSrc) * radToDeg);
+	}
+
+	Quat ToExportQuat(const Quat& aSrc)
+	{
+		const Vec3 xyzEuler = ToXyzEuler(aSrc);
+
+		//STAGE 3: make quaternion in xyz order using new xyz euler
+		//https://github.com/mrdoob/three.js/blob/61a4d5c90034e904d77f2787ee11dc512e51968d/src/math/Quaternion.js#L206
+		const float c1 = std::cos(xyzEuler.x / 2);
+		const float c2 = std::cos(xyzEuler.y / 2);
+		const float c3 = std::cos(xyzEuler.z / 2);
+
+		const float s1 = std::sin(xyzEuler.x / 2);
+		const float s2 = std::sin(xyzEuler.y / 2);
+		const float s3 = std::sin(xyzEuler.z / 2);
+
+		Quat xyzQuat;
+		xyzQuat.x = s1 * c2 * c3 + c1 * s2 * s3;
+		xyzQuat.y = c1 * s2 * c3 - s1 * c2 * s3;
+		xyzQuat.z = c1 * c2 * s3 + s1 * s2 * c3;
+		xyzQuat.w = c1 * c2 * c3 - s1 * s2 * s3;
+
+		//STAGE 4: swizzle xyzQuat into the right component layout for metronome
+		Quat result;
+		result.x = xyzQuat.y;
+		result.y = xyzQuat.z;
+		result.z = xyzQuat.x;
+		result.w = -xyzQuat.w;
+
+		return result;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+//engine independent math used by the exporter, everything in here is in unreal's coordinate space unless stated otherwise
+namespace metronome
+{
+	struct Vec3
+	{
+		float x, y, z;
+
+		bool operator==(const Vec3& aOther) const { return x == aOther.x && y == aOther.y && z == aOther.z; }
+		bool operator!=(const Vec3& aOther) const { return !operator==(aOther); }
+		Vec3 operator*(float aScalar) const { return { x * aScalar, y * aScalar, z * aScalar }; }
+		Vec3 operator-() const { return { -x, -y, -z }; }
+	};
+
+	struct Quat
+	{
+		float x, y, z, w;
+	};
+
+	struct Color
+	{
+		float r, g, b, a;
+	};
+
+	struct Transform
+	{
+		Vec3 myLocation;
+		Quat myRotation;
+		Vec3 myScale;
+	};
+
+	Vec3 Abs(const Vec3& aSrc);
+
+	//swizzles an unreal vector into metronome's axis layout
+	Vec3 ToExportVector(const Vec3& aSrc);
+
+	//euler angles (radians) in the xyz order
+	Vec3 ToXyzEuler(const Quat& aSrc);
+
+	//euler angles (degrees) in metronome's axis layout
+	Vec3 ToExportEuler(const Quat& aSrc);
+
+	Quat ToExportQuat(const Quat& aSrc);
+}
@@ -0,0 +1,232 @@
+#include "FabJson.h"
+#include <fstream>
+#include <iomanip>
+
+namespace metronome
+{
+	nlohmann::json CreateSceneJson(const nlohmann::json& aRoot)
+	{
+		nlohmann::json json;
+		json["fileVersion"] = "3.1";
+		json["root"] = aRoot;
+		return json;
+	}
+
+	nlohmann::json CreateEntityJson(const nlohmann::json& someComponents)
+	{
+		nlohmann::json entity;
+
+		entity["components"] = someComponents;
+
+		return entity;
+	}
+
+	nlohmann::json CreateFolderEntityJson(const std::string& aName, const std::vector<nlohmann::json>& someSubFolders, const std::vector<nlohmann::json>& someChildren)
+	{
+		nlohmann::json entity;
+		nlohmann::json& components = entity["components"];
+
+		components.push_back(CreateComponentJson("NameTag", CreateNameTagJson(aName + " [FOLDER]")));
+		nlohmann::json children;
+		for (const nlohmann::json& subFolder : someSubFolders)
+		{
+			children.push_back(subFolder);
+		}
+		for (const nlohmann::json& child : someChildren)
+		{
+			children.push_back(child);
+		}
+		nlohmann::json parent;
+		parent["children"] = children;
+		components.push_back(CreateComponentJson("Parent", parent));
+
+		return entity;
+	}
+
+	nlohmann::json CreateComponentJson(const std::string& aType, const nlohmann::json& aParams)
+	{
+		nlohmann::json result;
+
+		result["type"] = aType;
+		result["params"] = aParams;
+
+		return result;
+	}
+
+	nlohmann::json CreateNameTagJson(const std::string& aName)
+	{
+		nlohmann::json result;
+
+		result["name"] = aName;
+
+		return result;
+	}
+
+	nlohmann::json CreateParentJson(const std::vector<nlohmann::json>& someChildren)
+	{
+		nlohmann::json result;
+
+		for (size_t i = 0; i < someChildren.size(); i++)
+		{
+			result["children"][i] = someChildren[i];
+		}
+
+		return result;
+	}
+
+	nlohmann::json CreateTransformJson(const Transform& aSrc)
+	{
+		nlohmann::json result;
+
+		result["pos"] = CreateVectorJson(ToExportVector(aSrc.myLocation * 0.01f));
+		result["scale"] = CreateVectorJson(Abs(ToExportVector(aSrc.myScale)));
+		result["rot"] = CreateVectorJson(ToExportEuler(aSrc.myRotation));
+
+		return result;
+	}
+
+	nlohmann::json CreateLightJson(const Light& aSrc)
+	{
+		nlohmann::json result;
+
+		result["color"] = CreateColorJson(aSrc.myColor);
+		result["intensity"] = aSrc.myIntensity;
+
+		return result;
+	}
+
+	nlohmann::json CreatePointLightJson(const PointLight& aSrc)
+	{
+		nlohmann::json result = CreateLightJson(aSrc);
+
+		result["range"] = aSrc.myAttenuationRadius * 0.01f;
+
+		return result;
+	}
+
+	nlohmann::json CreateSpotLightJson(const SpotLight& aSrc)
+	{
+		nlohmann::json result = CreatePointLightJson(aSrc);
+
+		result["innerRadius"] = aSrc.myInnerConeAngle;
+		result["outerRadius"] = aSrc.myOuterConeAngle;
+
+		return result;
+	}
+
+	nlohmann::json CreateDirectionalLightJson(const DirectionalLight& aSrc)
+	{
+		nlohmann::json result = CreateLightJson(aSrc);
+
+		//no actions needed
+
+		return result;
+	}
+
+	nlohmann::json CreateMeshRendererJson(const MeshRenderer& aSrc)
+	{
+		nlohmann::json result;
+
+		result["modelPath"] = aSrc.myModelPath;
+		for (const std::string& materialPath : aSrc.myMaterialPaths)
+		{
+			result["materials"].push_back(materialPath);
+		}
+
+		return result;
+	}
+
+	nlohmann::json CreateCameraJson(const Camera& aSrc)
+	{
+		nlohmann::json result;
+
+		result["fov"] = aSrc.myFov;
+		result["nearPlane"] = aSrc.myNearPlane;
+		result["farPlane"] = aSrc.myFarPlane;
+
+		return result;
+	}
+
+	nlohmann::json CreateBoxColliderJson(const BoxCollider& aSrc)
+	{
+		nlohmann::json result;
+
+		result["size"] = CreateVectorJson(ToExportVector(aSrc.myExtent * 2));
+
+		return result;
+	}
+
+	nlohmann::json CreateSphereColliderJson(const SphereCollider& aSrc)
+	{
+		nlohmann::json result;
+
+		result["radius"] = aSrc.myRadius;
+
+		return result;
+	}
+
+	nlohmann::json CreateVectorJson(const Vec3& aSrc)
+	{
+		return {
+			{"x", aSrc.x},
+			{"y", aSrc.y},
+			{"z", aSrc.z}
+		};
+	}
+
+	nlohmann::json CreateQuatJson(const Quat& aSrc)
+	{
+		return {
+			{"x", aSrc.x},
+			{"y", aSrc.y},
+			{"z", aSrc.z},
+			{"w", aSrc.w}
+		};
+	}
+
+	nlohmann::json CreateColorJson(const Color& aSrc)
+	{
+		return {
+			{"r", aSrc.r},
+			{"g", aSrc.g},
+			{"b", aSrc.b},
+			{"a", aSrc.a}
+		};
+	}
+
+	bool WriteJsonToFile(const std::string& aPath, const nlohmann::json& aJson, bool aShouldMakeCompact)
+	{
+		std::ofstream stream(aPath);
+		if (!aShouldMakeCompact)
+		{
+			stream << std::setw(4);
+		}
+		stream << aJson;
+		stream.close();
+		return static_cast<bool>(stream);
+	}
+
+	const char* GetFabExtension(FabFormat aFormat)
+	{
+		switch (aFormat)
+		{
+		case FabFormat::MessagePack: return ".fab.msgpack";
+		case FabFormat::Cbor: return ".fab.cbor";
+		case FabFormat::Ubjson: return ".fab.ubj";
+		case FabFormat::Bson: return ".fab.bson";
+		default: return ".fab";
+		}
+	}
+
+	std::vector<std::uint8_t> EncodeBinaryJson(const nlohmann::json& aJson, FabFormat aFormat)
+	{
+		switch (aFormat)
+		{
+		case FabFormat::MessagePack: return nlohmann::json::to_msgpack(aJson);
+		case FabFormat::Cbor: return nlohmann::json::to_cbor(aJson);
+		case FabFormat::Ubjson: return nlohmann::json::to_ubjson(aJson);
+		case FabFormat::Bson: return nlohmann::json::to_bson(aJson);
+		default: return {};
+		}
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ExportMath.h"
+#include "json.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//builds the .fab scene document, all inputs are in unreal units and get converted here
+namespace metronome
+{
+	enum class FabFormat
+	{
+		Json,
+		MessagePack,
+		Cbor,
+		Ubjson,
+		Bson,
+	};
+
+	struct Light
+	{
+		Color myColor;
+		float myIntensity;
+	};
+
+	struct PointLight : Light
+	{
+		float myAttenuationRadius;
+	};
+
+	struct SpotLight : PointLight
+	{
+		float myInnerConeAngle;
+		float myOuterConeAngle;
+	};
+
+	struct DirectionalLight : Light
+	{
+	};
+
+	struct MeshRenderer
+	{
+		std::string myModelPath;
+		std::vector<std::string> myMaterialPaths;
+	};
+
+	struct Camera
+	{
+		float myFov;
+		float myNearPlane;
+		float myFarPlane;
+	};
+
+	struct BoxCollider
+	{
+		Vec3 myExtent;
+	};
+
+	struct SphereCollider
+	{
+		float myRadius;
+	};
+
+	nlohmann::json CreateSceneJson(const nlohmann::json& aRoot);
+	nlohmann::json CreateEntityJson(const nlohmann::json& someComponents);
+	//folders are listed before actors to keep them at the top of the hierarchy
+	nlohmann::json CreateFolderEntityJson(const std::string& aName, const std::vector<nlohmann::json>& someSubFolders, const std::vector<nlohmann::json>& someChildren);
+	nlohmann::json CreateComponentJson(const std::string& aType, const nlohmann::json& aParams);
+
+	nlohmann::json CreateNameTagJson(const std::string& aName);
+	nlohmann::json CreateParentJson(const std::vector<nlohmann::json>& someChildren);
+	nlohmann::json CreateTransformJson(const Transform& aSrc);
+	nlohmann::json CreateLightJson(const Light& aSrc);
+	nlohmann::json CreatePointLightJson(const PointLight& aSrc);
+	nlohmann::json CreateSpotLightJson(const SpotLight& aSrc);
+	nlohmann::json CreateDirectionalLightJson(const DirectionalLight& aSrc);
+	nlohmann::json CreateMeshRendererJson(const MeshRenderer& aSrc);
+	nlohmann::json CreateCameraJson(const Camera& aSrc);
+	nlohmann::json CreateBoxColliderJson(const BoxCollider& aSrc);
+	nlohmann::json CreateSphereColliderJson(const SphereCollider& aSrc);
+
+	nlohmann::json CreateVectorJson(const Vec3& aSrc);
+	nlohmann::json CreateQuatJson(const Quat& aSrc);
+	nlohmann::json CreateColorJson(const Color& aSrc);
+
+	bool WriteJsonToFile(const std::string& aPath, const nlohmann::json& aJson, bool aShouldMakeCompact);
+	//".fab" for json, the binary encodings add their own suffix so loaders can tell them apart
+	const char* GetFabExtension(FabFormat aFormat);
+	//aJson in one of nlohmann's binary encodings, empty for FabFormat::Json
+	std::vector<std::uint8_t> EncodeBinaryJson(const nlohmann::json& aJson, FabFormat aFormat);
+}
@@ -0,0 +1,628 @@
+#include "FabWriter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace metronome
+{
+	constexpr size_t flushSize = 1 << 20;
+	constexpr int indentSize = 4; //what WriteJsonToFile passes to setw
+
+	FabWriter::FabWriter(bool aShouldMakeCompact)
+		: FabWriter(FabFormat::Json, aShouldMakeCompact)
+	{
+	}
+
+	FabWriter::FabWriter(FabFormat aFormat, bool aShouldMakeCompact)
+		: myFormat(aFormat)
+		, myShouldMakeCompact(aShouldMakeCompact)
+	{
+		if (myFormat != FabFormat::Json)
+		{
+			myTree = std::make_unique<nlohmann::json>();
+			myTreeBuilder = std::make_unique<nlohmann::detail::json_sax_dom_parser<nlohmann::json>>(*myTree);
+		}
+	}
+
+	FabWriter::~FabWriter()
+	{
+		Close();
+	}
+
+	bool FabWriter::Open(const std::string& aPath)
+	{
+		Close();
+		//json goes through text mode like the std::ofstream in WriteJsonToFile, so line endings match too
+		myFile = std::fopen(aPath.c_str(), myTree ? "wb" : "w");
+		myHasFailed = myFile == nullptr;
+		myBuffer.reserve(flushSize + flushSize / 4);
+		return !myHasFailed;
+	}
+
+	bool FabWriter::Close()
+	{
+		if (myFile == nullptr)
+		{
+			return !myHasFailed;
+		}
+		if (myTree)
+		{
+			const std::vector<std::uint8_t> encoded = EncodeBinaryJson(*myTree, myFormat);
+			myHasFailed |= std::fwrite(encoded.data(), 1, encoded.size(), myFile) != encoded.size();
+			*myTree = nullptr;
+		}
+		Flush();
+		myHasFailed |= std::fclose(myFile) != 0;
+		myFile = nullptr;
+		return !myHasFailed;
+	}
+
+	void FabWriter::BeginObject()
+	{
+		if (myTreeBuilder)
+		{
+			myTreeBuilder->start_object(static_cast<size_t>(-1));
+			myScopes.push_back({ true, true });
+			return;
+		}
+		Begin('{', true);
+	}
+
+	void FabWriter::BeginArray()
+	{
+		if (myTreeBuilder)
+		{
+			myTreeBuilder->start_array(static_cast<size_t>(-1));
+			myScopes.push_back({ false, true });
+			return;
+		}
+		Begin('[', false);
+	}
+
+	void FabWriter::End()
+	{
+		if (myTreeBuilder)
+		{
+			myScopes.back().myIsObject ? myTreeBuilder->end_object() : myTreeBuilder->end_array();
+			myScopes.pop_back();
+			return;
+		}
+		const Scope scope = myScopes.back();
+		myScopes.pop_back();
+		if (!scope.myIsEmpty)
+		{
+			NewLine(myScopes.size());
+		}
+		myBuffer += scope.myIsObject ? '}' : ']';
+		Flush();
+	}
+
+	void FabWriter::Key(const char* aKey)
+	{
+		if (myTreeBuilder)
+		{
+			std::string key = aKey;
+			myTreeBuilder->key(key);
+			return;
+		}
+		Scope& scope = myScopes.back();
+		if (!scope.myIsEmpty)
+		{
+			myBuffer += ',';
+		}
+		scope.myIsEmpty = false;
+		NewLine(myScopes.size());
+		myBuffer += '"';
+		myBuffer += aKey;
+		myBuffer += myShouldMakeCompact ? "\":" : "\": ";
+	}
+
+	void FabWriter::Null()
+	{
+		if (myTreeBuilder)
+		{
+			myTreeBuilder->null();
+			return;
+		}
+		BeginValue();
+		myBuffer += "null";
+	}
+
+	void FabWriter::Float(float aValue)
+	{
+		//the json tree stores floats as double
+		const double value = aValue;
+		if (myTreeBuilder)
+		{
+			myTreeBuilder->number_float(value, {});
+			return;
+		}
+		BeginValue();
+		if (!std::isfinite(value))
+		{
+			myBuffer += "null";
+			return;
+		}
+		char digits[64];
+		myBuffer.append(digits, nlohmann::detail::to_chars(digits, digits + sizeof(digits), value));
+	}
+
+	void FabWriter::String(const std::string& aValue)
+	{
+		if (myTreeBuilder)
+		{
+			std::string value = aValue;
+			myTreeBuilder->string(value);
+			return;
+		}
+		BeginValue();
+		//the escapes nlohmann's serializer uses without ensure_ascii
+		static const char hexDigits[] = "0123456789abcdef";
+		myBuffer += '"';
+		for (const char character : aValue)
+		{
+			switch (character)
+			{
+			case '\b': myBuffer += "\\b"; break;
+			case '\t': myBuffer += "\\t"; break;
+			case '\n': myBuffer += "\\n"; break;
+			case '\f': myBuffer += "\\f"; break;
+			case '\r': myBuffer += "\\r"; break;
+			case '"': myBuffer += "\\\""; break;
+			case '\\': myBuffer += "\\\\"; break;
+			default:
+				if (static_cast<unsigned char>(character) <= 0x1F)
+				{
+					myBuffer += "\\u00";
+					myBuffer += hexDigits[character >> 4];
+					myBuffer += hexDigits[character & 0xF];
+				}
+				else
+				{
+					myBuffer += character;
+				}
+				break;
+			}
+		}
+		myBuffer += '"';
+	}
+
+	void FabWriter::Fragment(const std::string& aFragment)
+	{
+		BeginValue();
+		if (myShouldMakeCompact)
+		{
+			myBuffer += aFragment;
+		}
+		else
+		{
+			//strings in the fragment have their line breaks escaped, so every one of these is indentation
+			const size_t indent = myScopes.size() * indentSize;
+			size_t begin = 0;
+			for (size_t end = aFragment.find('\n'); end != std::string::npos; end = aFragment.find('\n', begin))
+			{
+				myBuffer.append(aFragment, begin, end + 1 - begin);
+				myBuffer.append(indent, ' ');
+				begin = end + 1;
+			}
+			myBuffer.append(aFragment, begin, std::string::npos);
+		}
+		Flush();
+	}
+
+	void FabWriter::BeginScene()
+	{
+		BeginObject();
+		Key("fileVersion");
+		String("3.1");
+		Key("root");
+	}
+
+	void FabWriter::EndScene()
+	{
+		End();
+	}
+
+	void FabWriter::BeginEntity()
+	{
+		BeginObject();
+		Key("components");
+		BeginArray();
+	}
+
+	void FabWriter::EndEntity()
+	{
+		End();
+		End();
+	}
+
+	void FabWriter::BeginComponent()
+	{
+		BeginObject();
+		Key("params");
+	}
+
+	void FabWriter::EndComponent(const char* aType)
+	{
+		Key("type");
+		String(aType);
+		End();
+	}
+
+	void FabWriter::BeginValue()
+	{
+		if (myScopes.empty() || myScopes.back().myIsObject)
+		{
+			return;
+		}
+		Scope& scope = myScopes.back();
+		if (!scope.myIsEmpty)
+		{
+			myBuffer += ',';
+		}
+		scope.myIsEmpty = false;
+		NewLine(myScopes.size());
+	}
+
+	void FabWriter::Begin(char anOpen, bool anIsObject)
+	{
+		BeginValue();
+		myBuffer += anOpen;
+		myScopes.push_back({ anIsObject, true });
+	}
+
+	void FabWriter::NewLine(size_t aDepth)
+	{
+		if (!myShouldMakeCompact)
+		{
+			myBuffer += '\n';
+			myBuffer.append(aDepth * indentSize, ' ');
+		}
+	}
+
+	void FabWriter::Flush()
+	{
+		if (myFile == nullptr || (myBuffer.size() < flushSize && !myScopes.empty()))
+		{
+			return;
+		}
+		myHasFailed |= std::fwrite(myBuffer.data(), 1, myBuffer.size(), myFile) != myBuffer.size();
+		myBuffer.clear();
+	}
+
+	static void WriteVector(FabWriter& aWriter, const Vec3& aSrc)
+	{
+		aWriter.BeginObject();
+		aWriter.Key("x");
+		aWriter.Float(aSrc.x);
+		aWriter.Key("y");
+		aWriter.Float(aSrc.y);
+		aWriter.Key("z");
+		aWriter.Float(aSrc.z);
+		aWriter.End();
+	}
+
+	static void WriteColor(FabWriter& aWriter, const Color& aSrc)
+	{
+		aWriter.BeginObject();
+		aWriter.Key("a");
+		aWriter.Float(aSrc.a);
+		aWriter.Key("b");
+		aWriter.Float(aSrc.b);
+		aWriter.Key("g");
+		aWriter.Float(aSrc.g);
+		aWriter.Key("r");
+		aWriter.Float(aSrc.r);
+		aWriter.End();
+	}
+
+	void BeginFolderEntity(FabWriter& aWriter, const std::string& aName, bool aHasChildren)
+	{
+		aWriter.BeginEntity();
+		WriteNameTagComponent(aWriter, aName + " [FOLDER]");
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("children");
+		if (aHasChildren)
+		{
+			aWriter.BeginArray();
+		}
+		else
+		{
+			aWriter.Null();
+		}
+	}
+
+	void EndFolderEntity(FabWriter& aWriter, bool aHasChildren)
+	{
+		if (aHasChildren)
+		{
+			aWriter.End();
+		}
+		aWriter.End();
+		aWriter.EndComponent("Parent");
+		aWriter.EndEntity();
+	}
+
+	void BeginParentComponent(FabWriter& aWriter, bool aHasChildren)
+	{
+		aWriter.BeginComponent();
+		if (aHasChildren)
+		{
+			aWriter.BeginObject();
+			aWriter.Key("children");
+			aWriter.BeginArray();
+		}
+		else
+		{
+			aWriter.Null();
+		}
+	}
+
+	void EndParentComponent(FabWriter& aWriter, bool aHasChildren)
+	{
+		if (aHasChildren)
+		{
+			aWriter.End();
+			aWriter.End();
+		}
+		aWriter.EndComponent("Parent");
+	}
+
+	void WriteNameTagComponent(FabWriter& aWriter, const std::string& aName)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("name");
+		aWriter.String(aName);
+		aWriter.End();
+		aWriter.EndComponent("NameTag");
+	}
+
+	void WriteTransformComponent(FabWriter& aWriter, const Transform& aSrc)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("pos");
+		WriteVector(aWriter, ToExportVector(aSrc.myLocation * 0.01f));
+		aWriter.Key("rot");
+		WriteVector(aWriter, ToExportEuler(aSrc.myRotation));
+		aWriter.Key("scale");
+		WriteVector(aWriter, Abs(ToExportVector(aSrc.myScale)));
+		aWriter.End();
+		aWriter.EndComponent("Transform");
+	}
+
+	void WritePointLightComponent(FabWriter& aWriter, const PointLight& aSrc)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("color");
+		WriteColor(aWriter, aSrc.myColor);
+		aWriter.Key("intensity");
+		aWriter.Float(aSrc.myIntensity);
+		aWriter.Key("range");
+		aWriter.Float(aSrc.myAttenuationRadius * 0.01f);
+		aWriter.End();
+		aWriter.EndComponent("PointLight");
+	}
+
+	void WriteSpotLightComponent(FabWriter& aWriter, const SpotLight& aSrc)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("color");
+		WriteColor(aWriter, aSrc.myColor);
+		aWriter.Key("innerRadius");
+		aWriter.Float(aSrc.myInnerConeAngle);
+		aWriter.Key("intensity");
+		aWriter.Float(aSrc.myIntensity);
+		aWriter.Key("outerRadius");
+		aWriter.Float(aSrc.myOuterConeAngle);
+		aWriter.Key("range");
+		aWriter.Float(aSrc.myAttenuationRadius * 0.01f);
+		aWriter.End();
+		aWriter.EndComponent("SpotLight");
+	}
+
+	void WriteDirectionalLightComponent(FabWriter& aWriter, const DirectionalLight& aSrc)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("color");
+		WriteColor(aWriter, aSrc.myColor);
+		aWriter.Key("intensity");
+		aWriter.Float(aSrc.myIntensity);
+		aWriter.End();
+		aWriter.EndComponent("DirectionalLight");
+	}
+
+	void WriteMeshRendererComponent(FabWriter& aWriter, const MeshRenderer& aSrc)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		if (!aSrc.myMaterialPaths.empty())
+		{
+			aWriter.Key("materials");
+			aWriter.BeginArray();
+			for (const std::string& materialPath : aSrc.myMaterialPaths)
+			{
+				aWriter.String(materialPath);
+			}
+			aWriter.End();
+		}
+		aWriter.Key("modelPath");
+		aWriter.String(aSrc.myModelPath);
+		aWriter.End();
+		aWriter.EndComponent("MeshRenderer");
+	}
+
+	void WriteCameraComponent(FabWriter& aWriter, const Camera& aSrc)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("farPlane");
+		aWriter.Float(aSrc.myFarPlane);
+		aWriter.Key("fov");
+		aWriter.Float(aSrc.myFov);
+		aWriter.Key("nearPlane");
+		aWriter.Float(aSrc.myNearPlane);
+		aWriter.End();
+		aWriter.EndComponent("Camera");
+	}
+
+	void WriteBoxColliderComponent(FabWriter& aWriter, const BoxCollider& aSrc)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("size");
+		WriteVector(aWriter, ToExportVector(aSrc.myExtent * 2));
+		aWriter.End();
+		aWriter.EndComponent("BoxCollider");
+	}
+
+	void WriteSphereColliderComponent(FabWriter& aWriter, const SphereCollider& aSrc)
+	{
+		aWriter.BeginComponent();
+		aWriter.BeginObject();
+		aWriter.Key("radius");
+		aWriter.Float(aSrc.myRadius);
+		aWriter.End();
+		aWriter.EndComponent("SphereCollider");
+	}
+
+	template <typename T, typename WriteFn>
+	static void WriteComponents(FabWriter& aWriter, const std::vector<SceneComponent<T>>& someComponents, std::uint32_t anEntity, WriteFn aWrite)
+	{
+		const auto range = FindSceneComponents(someComponents, anEntity);
+		for (const SceneComponent<T>* component = range.first; component != range.second; ++component)
+		{
+			aWrite(aWriter, component->myData);
+		}
+	}
+
+	//actors directly inside a folder are serialized on their own with their children, then stitched back in entity order.
+	//entities are depth first, so that order is the output order
+	struct SceneWriteContext
+	{
+		const SceneSnapshot* mySnapshot = nullptr;
+		std::vector<std::uint32_t> myChildOffsets;
+		std::vector<std::uint32_t> myChildren;
+		bool myShouldMakeCompact = true;
+		ParallelForFn myParallelFor;
+		std::vector<std::uint32_t> myFragmentEntities;
+		std::vector<std::string> myFragments; //of the current batch
+		size_t myBatchBegin = 0;
+		size_t myNextFragment = 0;
+	};
+
+	constexpr size_t fragmentsPerBatch = 4096; //bounds how much of the document is held in memory
+	constexpr size_t fragmentsPerTask = 64;
+	//stitching costs more than it saves below this, the scene is written serially then
+	constexpr size_t minParallelFragments = 4 * fragmentsPerTask;
+
+	static void WriteSnapshotEntity(FabWriter& aWriter, SceneWriteContext& aContext, std::uint32_t anEntity);
+
+	static void WriteFragmentOrEntity(FabWriter& aWriter, SceneWriteContext& aContext, std::uint32_t anEntity)
+	{
+		if (aContext.myNextFragment == aContext.myFragmentEntities.size() || aContext.myFragmentEntities[aContext.myNextFragment] != anEntity)
+		{
+			WriteSnapshotEntity(aWriter, aContext, anEntity);
+			return;
+		}
+
+		if (aContext.myNextFragment == aContext.myBatchBegin + aContext.myFragments.size())
+		{
+			aContext.myBatchBegin = aContext.myNextFragment;
+			const size_t batchSize = std::min(fragmentsPerBatch, aContext.myFragmentEntities.size() - aContext.myBatchBegin);
+			aContext.myFragments.assign(batchSize, {});
+			const int taskCount = static_cast<int>((batchSize + fragmentsPerTask - 1) / fragmentsPerTask);
+			aContext.myParallelFor(taskCount, [&](int aTask) {
+				const size_t end = std::min(batchSize, (aTask + 1) * fragmentsPerTask);
+				for (size_t i = aTask * fragmentsPerTask; i < end; ++i)
+				{
+					FabWriter fragmentWriter(aContext.myShouldMakeCompact);
+					WriteSnapshotEntity(fragmentWriter, aContext, aContext.myFragmentEntities[aContext.myBatchBegin + i]);
+					aContext.myFragments[i] = fragmentWriter.TakeBuffer();
+				}
+			});
+		}
+
+		std::string& fragment = aContext.myFragments[aContext.myNextFragment - aContext.myBatchBegin];
+		aWriter.Fragment(fragment);
+		std::string().swap(fragment);
+		++aContext.myNextFragment;
+	}
+
+	static void WriteSnapshotEntity(FabWriter& aWriter, SceneWriteContext& aContext, std::uint32_t anEntity)
+	{
+		const SceneSnapshot& snapshot = *aContext.mySnapshot;
+		const SceneEntity& entity = snapshot.myEntities[anEntity];
+		const std::uint32_t firstChild = aContext.myChildOffsets[anEntity];
+		const std::uint32_t lastChild = aContext.myChildOffsets[anEntity + 1];
+		const bool hasChildren = firstChild != lastChild;
+		if (entity.myIsFolder)
+		{
+			BeginFolderEntity(aWriter, entity.myName, hasChildren);
+			for (std::uint32_t i = firstChild; i < lastChild; ++i)
+			{
+				WriteFragmentOrEntity(aWriter, aContext, aContext.myChildren[i]);
+			}
+			EndFolderEntity(aWriter, hasChildren);
+			return;
+		}
+
+		aWriter.BeginEntity();
+		WriteNameTagComponent(aWriter, entity.myName);
+		BeginParentComponent(aWriter, hasChildren);
+		for (std::uint32_t i = firstChild; i < lastChild; ++i)
+		{
+			WriteSnapshotEntity(aWriter, aContext, aContext.myChildren[i]);
+		}
+		EndParentComponent(aWriter, hasChildren);
+		WriteComponents(aWriter, snapshot.myTransforms, anEntity, WriteTransformComponent);
+		WriteComponents(aWriter, snapshot.myPointLights, anEntity, WritePointLightComponent);
+		WriteComponents(aWriter, snapshot.mySpotLights, anEntity, WriteSpotLightComponent);
+		WriteComponents(aWriter, snapshot.myDirectionalLights, anEntity, WriteDirectionalLightComponent);
+		WriteComponents(aWriter, snapshot.myMeshRenderers, anEntity, WriteMeshRendererComponent);
+		WriteComponents(aWriter, snapshot.myCameras, anEntity, WriteCameraComponent);
+		WriteComponents(aWriter, snapshot.myBoxColliders, anEntity, WriteBoxColliderComponent);
+		WriteComponents(aWriter, snapshot.mySphereColliders, anEntity, WriteSphereColliderComponent);
+		aWriter.EndEntity();
+	}
+
+	void WriteScene(FabWriter& aWriter, const SceneSnapshot& aSnapshot, const ParallelForFn& aParallelFor)
+	{
+		SceneWriteContext context;
+		context.mySnapshot = &aSnapshot;
+		GetSceneChildren(aSnapshot, context.myChildOffsets, context.myChildren);
+		//the tree the binary formats build can't be split up
+		if (aParallelFor && aWriter.IsText())
+		{
+			context.myShouldMakeCompact = aWriter.IsCompact();
+			context.myParallelFor = aParallelFor;
+			for (size_t i = 0; i < aSnapshot.myEntities.size(); ++i)
+			{
+				const SceneEntity& entity = aSnapshot.myEntities[i];
+				if (!entity.myIsFolder && entity.myParent >= 0 && aSnapshot.myEntities[entity.myParent].myIsFolder)
+				{
+					context.myFragmentEntities.push_back(static_cast<std::uint32_t>(i));
+				}
+			}
+			if (context.myFragmentEntities.size() < minParallelFragments)
+			{
+				context.myFragmentEntities.clear();
+			}
+		}
+
+		aWriter.BeginScene();
+		if (aSnapshot.myEntities.empty())
+		{
+			aWriter.Null();
+		}
+		else
+		{
+			WriteFragmentOrEntity(aWriter, context, 0);
+		}
+		aWriter.EndScene();
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "FabJson.h"
+#include "Parallel.h"
+#include "SceneSnapshot.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+//streams the .fab scene document without building a json tree.
+//the output is byte for byte what WriteJsonToFile makes of the matching CreateXJson tree, as long as object keys are
+//written in ascending order (nlohmann keeps objects sorted) and strings are valid utf-8
+namespace metronome
+{
+	class FabWriter
+	{
+	public:
+		explicit FabWriter(bool aShouldMakeCompact);
+		//binary formats collect the document in a json tree and encode it on Close, so they don't stream
+		explicit FabWriter(FabFormat aFormat, bool aShouldMakeCompact = true);
+		~FabWriter();
+		FabWriter(const FabWriter&) = delete;
+		FabWriter& operator=(const FabWriter&) = delete;
+
+		//without a file a json document collects in GetBuffer
+		bool Open(const std::string& aPath);
+		bool Close();
+		const std::string& GetBuffer() const { return myBuffer; }
+		std::string TakeBuffer() { return std::move(myBuffer); }
+		bool IsText() const { return !myTree; }
+		bool IsCompact() const { return myShouldMakeCompact; }
+
+		void BeginObject();
+		void BeginArray();
+		void End();
+		void Key(const char* aKey);
+		void Null();
+		void Float(float aValue);
+		void String(const std::string& aValue);
+		//a value another text writer made from scratch, reindented to where it goes
+		void Fragment(const std::string& aFragment);
+
+		void BeginScene(); //the root entity comes next
+		void EndScene();
+		void BeginEntity();
+		void EndEntity();
+		//write the params value in between, EndComponent adds the type after it
+		void BeginComponent();
+		void EndComponent(const char* aType);
+
+	private:
+		struct Scope
+		{
+			bool myIsObject;
+			bool myIsEmpty;
+		};
+
+		void BeginValue();
+		void Begin(char anOpen, bool anIsObject);
+		void NewLine(size_t aDepth);
+		void Flush();
+
+		std::string myBuffer;
+		std::vector<Scope> myScopes;
+		std::FILE* myFile = nullptr;
+		FabFormat myFormat;
+		std::unique_ptr<nlohmann::json> myTree;
+		std::unique_ptr<nlohmann::detail::json_sax_dom_parser<nlohmann::json>> myTreeBuilder;
+		bool myShouldMakeCompact;
+		bool myHasFailed = false;
+	};
+
+	//folders are listed before actors to keep them at the top of the hierarchy, see CreateFolderEntityJson
+	void BeginFolderEntity(FabWriter& aWriter, const std::string& aName, bool aHasChildren);
+	void EndFolderEntity(FabWriter& aWriter, bool aHasChildren);
+	//child entities go in between, an empty parent has null params
+	void BeginParentComponent(FabWriter& aWriter, bool aHasChildren);
+	void EndParentComponent(FabWriter& aWriter, bool aHasChildren);
+
+	void WriteNameTagComponent(FabWriter& aWriter, const std::string& aName);
+	void WriteTransformComponent(FabWriter& aWriter, const Transform& aSrc);
+	void WritePointLightComponent(FabWriter& aWriter, const PointLight& aSrc);
+	void WriteSpotLightComponent(FabWriter& aWriter, const SpotLight& aSrc);
+	void WriteDirectionalLightComponent(FabWriter& aWriter, const DirectionalLight& aSrc);
+	void WriteMeshRendererComponent(FabWriter& aWriter, const MeshRenderer& aSrc);
+	void WriteCameraComponent(FabWriter& aWriter, const Camera& aSrc);
+	void WriteBoxColliderComponent(FabWriter& aWriter, const BoxCollider& aSrc);
+	void WriteSphereColliderComponent(FabWriter& aWriter, const SphereCollider& aSrc);
+
+	//the whole document, the snapshot's first entity is the root.
+	//with aParallelFor, text is serialized an actor subtree per task and stitched back in order.
+	//scenes with only a few actors directly in folders are still written serially
+	void WriteScene(FabWriter& aWriter, const SceneSnapshot& aSnapshot, const ParallelForFn& aParallelFor = {});
+}
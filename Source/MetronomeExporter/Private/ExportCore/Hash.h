@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace metronome
+{
+	constexpr std::uint64_t fnvOffsetBasis = 0xCBF29CE484222325ull;
+
+	//64 bit FNV-1a, pass the previous result as aHash to continue a running hash
+	inline std::uint64_t Fnv1a64(const void* someData, size_t aSize, std::uint64_t aHash = fnvOffsetBasis)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(someData);
+		for (size_t i = 0; i < aSize; ++i)
+		{
+			aHash ^= bytes[i];
+			aHash *= 0x100000001B3ull;
+		}
+		return aHash;
+	}
+}
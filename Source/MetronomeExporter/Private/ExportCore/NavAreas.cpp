@@ -0,0 +1,42 @@
+#include "NavAreas.h"
+
+namespace metronome
+{
+	void AddNavAreaSections(NavBinaryWriter& aWriter, const NavGraph& aGraph, const NavMesh& aMesh, const std::vector<NavAreaCost>& someAreaCosts)
+	{
+		aWriter.AddSection(NavSection::polyAreas, aGraph.myAreas);
+		aWriter.AddSection(NavSection::polyFlags, aGraph.myFlags);
+
+		const std::vector<std::uint32_t> trianglePolys = GetTrianglePolys(aGraph, aMesh);
+		if (!trianglePolys.empty())
+		{
+			std::vector<std::uint8_t> triangleAreas;
+			std::vector<std::uint16_t> triangleFlags;
+			triangleAreas.reserve(trianglePolys.size());
+			triangleFlags.reserve(trianglePolys.size());
+			for (std::uint32_t poly : trianglePolys)
+			{
+				triangleAreas.push_back(aGraph.myAreas[poly]);
+				triangleFlags.push_back(aGraph.myFlags[poly]);
+			}
+			aWriter.AddSection(NavSection::triangleAreas, triangleAreas);
+			aWriter.AddSection(NavSection::triangleFlags, triangleFlags);
+		}
+
+		aWriter.AddSection(NavSection::areaCosts, someAreaCosts);
+
+		std::vector<NavOffMeshLink> links = aGraph.myOffMeshLinks;
+		for (NavOffMeshLink& link : links)
+		{
+			const Vec3 start = ToExportVector({ link.myStart[0], link.myStart[1], link.myStart[2] });
+			const Vec3 end = ToExportVector({ link.myEnd[0], link.myEnd[1], link.myEnd[2] });
+			link.myStart[0] = start.x;
+			link.myStart[1] = start.y;
+			link.myStart[2] = start.z;
+			link.myEnd[0] = end.x;
+			link.myEnd[1] = end.y;
+			link.myEnd[2] = end.z;
+		}
+		aWriter.AddSection(NavSection::offMeshLinks, links);
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "NavBinary.h"
+#include "NavGraph.h"
+#include "NavMesh.h"
+#include <vector>
+
+namespace metronome
+{
+	//what the default query filter charges for an area, a path pays myCost per unit travelled plus myFixedCost on entering
+	struct NavAreaCost
+	{
+		float myCost;
+		float myFixedCost;
+	};
+	static_assert(sizeof(NavAreaCost) == 8, "NavAreaCost layout changed");
+
+	//adds area ids and flags per poly and per triangle, the area cost table and the off-mesh links
+	void AddNavAreaSections(NavBinaryWriter& aWriter, const NavGraph& aGraph, const NavMesh& aMesh, const std::vector<NavAreaCost>& someAreaCosts);
+}
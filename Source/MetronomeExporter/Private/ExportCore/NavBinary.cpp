@@ -0,0 +1,350 @@
+#include "NavBinary.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace metronome
+{
+	static size_t AlignUp(size_t aValue)
+	{
+		return (aValue + navBinaryAlignment - 1) & ~(navBinaryAlignment - 1);
+	}
+
+	void NavBinaryWriter::AddSection(std::uint32_t anId, const void* someData, size_t aSize)
+	{
+		Section section;
+		section.myId = anId;
+		section.myData.resize(aSize);
+		if (aSize > 0)
+		{
+			std::memcpy(section.myData.data(), someData, aSize);
+		}
+		mySections.push_back(std::move(section));
+	}
+
+	std::vector<unsigned char> NavBinaryWriter::Build() const
+	{
+		std::vector<NavBinarySection> table(mySections.size());
+		size_t offset = AlignUp(sizeof(NavBinaryHeader) + sizeof(NavBinarySection) * mySections.size());
+		for (size_t i = 0; i < mySections.size(); ++i)
+		{
+			table[i].myId = mySections[i].myId;
+			table[i].myReserved = 0;
+			table[i].myOffset = offset;
+			table[i].mySize = mySections[i].myData.size();
+			offset = AlignUp(offset + mySections[i].myData.size());
+		}
+
+		std::vector<unsigned char> buffer(offset, 0);
+		std::memcpy(buffer.data() + sizeof(NavBinaryHeader), table.data(), sizeof(NavBinarySection) * table.size());
+		for (size_t i = 0; i < mySections.size(); ++i)
+		{
+			if (!mySections[i].myData.empty())
+			{
+				std::memcpy(buffer.data() + table[i].myOffset, mySections[i].myData.data(), mySections[i].myData.size());
+			}
+		}
+
+		NavBinaryHeader header;
+		header.myMagic = myMagic;
+		header.myVersion = navBinaryVersion;
+		header.myFlags = myFlags;
+		header.mySectionCount = static_cast<std::uint32_t>(mySections.size());
+		header.myFileSize = buffer.size();
+		header.myChecksum = Fnv1a64(buffer.data() + sizeof(NavBinaryHeader), buffer.size() - sizeof(NavBinaryHeader));
+		std::memcpy(buffer.data(), &header, sizeof(header));
+		return buffer;
+	}
+
+	bool NavBinaryWriter::Write(const std::string& aPath) const
+	{
+		const std::vector<unsigned char> buffer = Build();
+		std::ofstream file(aPath, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		return static_cast<bool>(file);
+	}
+
+	bool NavBinaryView::Init(const void* someData, size_t aSize, std::uint32_t aMagic)
+	{
+		myData = nullptr;
+		myHeader = nullptr;
+		mySections = nullptr;
+		if (someData == nullptr || aSize < sizeof(NavBinaryHeader))
+		{
+			return false;
+		}
+
+		const unsigned char* data = static_cast<const unsigned char*>(someData);
+		const NavBinaryHeader* header = reinterpret_cast<const NavBinaryHeader*>(data);
+		if (header->myMagic != aMagic || header->myVersion != navBinaryVersion || header->myFileSize != aSize)
+		{
+			return false;
+		}
+		if (sizeof(NavBinaryHeader) + sizeof(NavBinarySection) * static_cast<size_t>(header->mySectionCount) > aSize)
+		{
+			return false;
+		}
+		if (Fnv1a64(data + sizeof(NavBinaryHeader), aSize - sizeof(NavBinaryHeader)) != header->myChecksum)
+		{
+			return false;
+		}
+
+		const NavBinarySection* sections = reinterpret_cast<const NavBinarySection*>(data + sizeof(NavBinaryHeader));
+		for (std::uint32_t i = 0; i < header->mySectionCount; ++i)
+		{
+			if (sections[i].myOffset > aSize || sections[i].mySize > aSize - sections[i].myOffset)
+			{
+				return false;
+			}
+		}
+
+		myData = data;
+		myHeader = header;
+		mySections = sections;
+		return true;
+	}
+
+	const void* NavBinaryView::FindSection(std::uint32_t anId, size_t* aSizeOut) const
+	{
+		if (myHeader == nullptr)
+		{
+			return nullptr;
+		}
+		for (std::uint32_t i = 0; i < myHeader->mySectionCount; ++i)
+		{
+			if (mySections[i].myId == anId)
+			{
+				if (aSizeOut != nullptr)
+				{
+					*aSizeOut = static_cast<size_t>(mySections[i].mySize);
+				}
+				return myData + mySections[i].myOffset;
+			}
+		}
+		return nullptr;
+	}
+
+	template <typename Index>
+	static std::vector<Index> CreateIndexBuffer(const NavMesh& aMesh)
+	{
+		std::vector<Index> indices;
+		indices.reserve(aMesh.myFaces.size() * 3);
+		for (const Face& face : aMesh.myFaces)
+		{
+			indices.push_back(static_cast<Index>(face.x - 1));
+			indices.push_back(static_cast<Index>(face.y - 1));
+			indices.push_back(static_cast<Index>(face.z - 1));
+		}
+		return indices;
+	}
+
+	static std::uint16_t Quantize(float aValue, float aMin, float aMax)
+	{
+		if (aMax <= aMin)
+		{
+			return 0;
+		}
+		const float scaled = (aValue - aMin) / (aMax - aMin) * 65535.0f + 0.5f;
+		return static_cast<std::uint16_t>(std::min(std::max(scaled, 0.0f), 65535.0f));
+	}
+
+	static void AppendVarint(std::vector<unsigned char>& aBuffer, std::uint32_t aValue)
+	{
+		while (aValue >= 0x80)
+		{
+			aBuffer.push_back(static_cast<unsigned char>(aValue | 0x80));
+			aValue >>= 7;
+		}
+		aBuffer.push_back(static_cast<unsigned char>(aValue));
+	}
+
+	//consecutive indices of a tile are close, so the deltas mostly fit in one byte
+	static void AppendIndexDeltas(std::vector<unsigned char>& aBuffer, const NavMesh& aMesh, const NavTile& aRange)
+	{
+		std::int64_t previous = 0;
+		for (std::uint32_t i = 0; i < aRange.myFaceCount; ++i)
+		{
+			const Face& face = aMesh.myFaces[aRange.myFirstFace + i];
+			for (std::uint32_t index : { face.x - 1, face.y - 1, face.z - 1 })
+			{
+				const std::int64_t delta = static_cast<std::int64_t>(index) - previous;
+				const std::uint32_t zigzag = static_cast<std::uint32_t>(delta < 0 ? ((-delta) << 1) - 1 : delta << 1);
+				AppendVarint(aBuffer, zigzag);
+				previous = index;
+			}
+		}
+	}
+
+	void AddNavMeshSections(NavBinaryWriter& aWriter, const NavMesh& aMesh, bool aShouldCompress)
+	{
+		std::vector<float> positions;
+		positions.reserve(aMesh.myVertices.size() * 3);
+		for (const Vec3& vertex : aMesh.myVertices)
+		{
+			const Vec3 exportVertex = ToExportVector(vertex);
+			positions.push_back(exportVertex.x);
+			positions.push_back(exportVertex.y);
+			positions.push_back(exportVertex.z);
+		}
+
+		std::vector<NavBinaryTile> tiles;
+		for (const NavTile& range : aMesh.myTiles)
+		{
+			NavBinaryTile tile = {};
+			tile.myX = range.myX;
+			tile.myY = range.myY;
+			tile.myLayer = range.myLayer;
+			tile.myFirstVertex = range.myFirstVertex;
+			tile.myVertexCount = range.myVertexCount;
+			tile.myFirstIndex = range.myFirstFace * 3;
+			tile.myIndexCount = range.myFaceCount * 3;
+
+			std::fill(tile.myBoundsMin, tile.myBoundsMin + 3, std::numeric_limits<float>::max());
+			std::fill(tile.myBoundsMax, tile.myBoundsMax + 3, std::numeric_limits<float>::lowest());
+			for (std::uint32_t i = 0; i < range.myFaceCount; ++i)
+			{
+				const Face& face = aMesh.myFaces[range.myFirstFace + i];
+				for (std::uint32_t index : { face.x, face.y, face.z })
+				{
+					const float* position = &positions[(index - 1) * 3];
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						tile.myBoundsMin[axis] = std::min(tile.myBoundsMin[axis], position[axis]);
+						tile.myBoundsMax[axis] = std::max(tile.myBoundsMax[axis], position[axis]);
+					}
+				}
+			}
+			if (range.myFaceCount == 0)
+			{
+				std::fill(tile.myBoundsMin, tile.myBoundsMin + 3, 0.0f);
+				std::fill(tile.myBoundsMax, tile.myBoundsMax + 3, 0.0f);
+			}
+			tiles.push_back(tile);
+		}
+
+		aWriter.AddSection(NavSection::tiles, tiles);
+
+		if (aShouldCompress)
+		{
+			std::vector<std::uint16_t> quantized(positions.size(), 0);
+			std::vector<unsigned char> indexBytes;
+			std::vector<std::uint32_t> indexOffsets;
+			for (size_t tileIndex = 0; tileIndex < tiles.size(); ++tileIndex)
+			{
+				const NavBinaryTile& tile = tiles[tileIndex];
+				for (std::uint32_t i = tile.myFirstVertex; i < tile.myFirstVertex + tile.myVertexCount; ++i)
+				{
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						quantized[i * 3 + axis] = Quantize(positions[i * 3 + axis], tile.myBoundsMin[axis], tile.myBoundsMax[axis]);
+					}
+				}
+				indexOffsets.push_back(static_cast<std::uint32_t>(indexBytes.size()));
+				AppendIndexDeltas(indexBytes, aMesh, aMesh.myTiles[tileIndex]);
+			}
+			indexOffsets.push_back(static_cast<std::uint32_t>(indexBytes.size()));
+
+			aWriter.SetFlags(NavBinaryFlags::quantizedPositions | NavBinaryFlags::compressedIndices);
+			aWriter.AddSection(NavSection::quantizedPositions, quantized);
+			aWriter.AddSection(NavSection::compressedIndices, indexBytes);
+			aWriter.AddSection(NavSection::compressedIndexOffsets, indexOffsets);
+			return;
+		}
+
+		aWriter.AddSection(NavSection::positions, positions);
+
+		//16 bit indices whenever every vertex fits
+		if (aMesh.myVertices.size() <= std::numeric_limits<std::uint16_t>::max() + size_t(1))
+		{
+			aWriter.SetFlags(NavBinaryFlags::sixteenBitIndices);
+			aWriter.AddSection(NavSection::indices, CreateIndexBuffer<std::uint16_t>(aMesh));
+		}
+		else
+		{
+			aWriter.AddSection(NavSection::indices, CreateIndexBuffer<std::uint32_t>(aMesh));
+		}
+	}
+
+	std::vector<float> DecodeNavPositions(const NavBinaryView& aView)
+	{
+		size_t size = 0;
+		if (const void* positions = aView.FindSection(NavSection::positions, &size))
+		{
+			const float* begin = static_cast<const float*>(positions);
+			return std::vector<float>(begin, begin + size / sizeof(float));
+		}
+
+		size_t tileSize = 0;
+		const std::uint16_t* quantized = static_cast<const std::uint16_t*>(aView.FindSection(NavSection::quantizedPositions, &size));
+		const NavBinaryTile* tiles = static_cast<const NavBinaryTile*>(aView.FindSection(NavSection::tiles, &tileSize));
+		if (quantized == nullptr || tiles == nullptr)
+		{
+			return {};
+		}
+
+		std::vector<float> result(size / sizeof(std::uint16_t), 0.0f);
+		for (size_t tileIndex = 0; tileIndex < tileSize / sizeof(NavBinaryTile); ++tileIndex)
+		{
+			const NavBinaryTile& tile = tiles[tileIndex];
+			for (std::uint32_t i = tile.myFirstVertex; i < tile.myFirstVertex + tile.myVertexCount && i * 3 + 2 < result.size(); ++i)
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const float extent = tile.myBoundsMax[axis] - tile.myBoundsMin[axis];
+					result[i * 3 + axis] = tile.myBoundsMin[axis] + quantized[i * 3 + axis] * (extent / 65535.0f);
+				}
+			}
+		}
+		return result;
+	}
+
+	std::vector<std::uint32_t> DecodeNavIndices(const NavBinaryView& aView)
+	{
+		size_t size = 0;
+		if (const void* indices = aView.FindSection(NavSection::indices, &size))
+		{
+			if ((aView.GetHeader().myFlags & NavBinaryFlags::sixteenBitIndices) != 0)
+			{
+				const std::uint16_t* begin = static_cast<const std::uint16_t*>(indices);
+				return std::vector<std::uint32_t>(begin, begin + size / sizeof(std::uint16_t));
+			}
+			const std::uint32_t* begin = static_cast<const std::uint32_t*>(indices);
+			return std::vector<std::uint32_t>(begin, begin + size / sizeof(std::uint32_t));
+		}
+
+		size_t offsetSize = 0;
+		const unsigned char* bytes = static_cast<const unsigned char*>(aView.FindSection(NavSection::compressedIndices, &size));
+		const std::uint32_t* offsets = static_cast<const std::uint32_t*>(aView.FindSection(NavSection::compressedIndexOffsets, &offsetSize));
+		if (bytes == nullptr || offsets == nullptr)
+		{
+			return {};
+		}
+
+		std::vector<std::uint32_t> result;
+		for (size_t tileIndex = 0; tileIndex + 1 < offsetSize / sizeof(std::uint32_t); ++tileIndex)
+		{
+			std::int64_t previous = 0;
+			size_t position = offsets[tileIndex];
+			const size_t end = std::min<size_t>(offsets[tileIndex + 1], size);
+			while (position < end)
+			{
+				std::uint32_t zigzag = 0;
+				for (int shift = 0; position < end && shift < 35; shift += 7)
+				{
+					const unsigned char byte = bytes[position++];
+					zigzag |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+					if ((byte & 0x80) == 0)
+					{
+						break;
+					}
+				}
+				const std::int64_t delta = (zigzag & 1) != 0 ? -static_cast<std::int64_t>(zigzag >> 1) - 1 : static_cast<std::int64_t>(zigzag >> 1);
+				previous += delta;
+				result.push_back(static_cast<std::uint32_t>(previous));
+			}
+		}
+		return result;
+	}
+}
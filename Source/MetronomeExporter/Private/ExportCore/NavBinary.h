@@ -0,0 +1,175 @@
+#pragma once
+
+#include "NavMesh.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//binary nav output, laid out so a runtime can mmap the file and use the buffers in place.
+//
+//file layout (little endian):
+//	NavBinaryHeader
+//	NavBinarySection[mySectionCount]
+//	section payloads, each starting on a 16 byte boundary
+//
+//every offset is relative to the start of the file, the checksum covers everything after the header
+namespace metronome
+{
+	constexpr std::uint32_t MakeFourCC(char aA, char aB, char aC, char aD)
+	{
+		return static_cast<std::uint32_t>(static_cast<unsigned char>(aA))
+			| static_cast<std::uint32_t>(static_cast<unsigned char>(aB)) << 8
+			| static_cast<std::uint32_t>(static_cast<unsigned char>(aC)) << 16
+			| static_cast<std::uint32_t>(static_cast<unsigned char>(aD)) << 24;
+	}
+
+	constexpr std::uint32_t navBinaryMagic = MakeFourCC('M', 'N', 'A', 'V');
+	constexpr std::uint32_t navBinaryVersion = 1;
+	constexpr size_t navBinaryAlignment = 16;
+
+	namespace NavBinaryFlags
+	{
+		constexpr std::uint32_t sixteenBitIndices = 1 << 0; //INDX holds uint16 instead of uint32
+		constexpr std::uint32_t quantizedPositions = 1 << 1; //QPOS replaces VPOS
+		constexpr std::uint32_t compressedIndices = 1 << 2; //QIDX and QIOF replace INDX
+	}
+
+	namespace NavSection
+	{
+		constexpr std::uint32_t tiles = MakeFourCC('T', 'I', 'L', 'E'); //NavBinaryTile[]
+		constexpr std::uint32_t positions = MakeFourCC('V', 'P', 'O', 'S'); //float[3] per vertex, metronome axis layout
+		constexpr std::uint32_t indices = MakeFourCC('I', 'N', 'D', 'X'); //uint16 or uint32, three per triangle
+		//compressed geometry, see AddNavMeshSections
+		constexpr std::uint32_t quantizedPositions = MakeFourCC('Q', 'P', 'O', 'S'); //uint16[3] per vertex inside the bounds of the tile that owns it
+		constexpr std::uint32_t compressedIndices = MakeFourCC('Q', 'I', 'D', 'X'); //zigzag varint index deltas, restarting from 0 at every tile
+		constexpr std::uint32_t compressedIndexOffsets = MakeFourCC('Q', 'I', 'O', 'F'); //uint32 byte offset into QIDX per TILE entry, plus the total at the end
+		//point location, see NavBvh.h
+		constexpr std::uint32_t bvhNodes = MakeFourCC('B', 'V', 'H', 'N'); //NavBvhNode[] in depth first order
+		constexpr std::uint32_t bvhTriangles = MakeFourCC('B', 'V', 'H', 'T'); //uint32 triangle per leaf slot
+		constexpr std::uint32_t stitches = MakeFourCC('S', 'T', 'C', 'H'); //NavStitch[] in chunk files, see NavChunks.h
+
+		//poly adjacency, see NavGraph.h. polys are numbered tile by tile in TILE order
+		constexpr std::uint32_t polyTiles = MakeFourCC('P', 'T', 'I', 'L'); //uint32 first poly per TILE entry, plus the total at the end
+		constexpr std::uint32_t polyCentroids = MakeFourCC('P', 'C', 'E', 'N'); //float[3] per poly, metronome axis layout
+		constexpr std::uint32_t polyLinkOffsets = MakeFourCC('P', 'L', 'O', 'F'); //uint32 first link per poly, plus the total at the end
+		constexpr std::uint32_t polyLinks = MakeFourCC('P', 'L', 'N', 'K'); //uint32 neighbour poly per link
+		constexpr std::uint32_t polyPortals = MakeFourCC('P', 'P', 'R', 'T'); //float[6] per link, the shared edge in the source poly's winding
+
+		//surface costs, see NavAreas.h
+		constexpr std::uint32_t polyAreas = MakeFourCC('P', 'A', 'R', 'E'); //uint8 detour area id per poly
+		constexpr std::uint32_t polyFlags = MakeFourCC('P', 'F', 'L', 'G'); //uint16 detour poly flags per poly
+		constexpr std::uint32_t triangleAreas = MakeFourCC('T', 'A', 'R', 'E'); //uint8 area id per triangle
+		constexpr std::uint32_t triangleFlags = MakeFourCC('T', 'F', 'L', 'G'); //uint16 poly flags per triangle
+		constexpr std::uint32_t areaCosts = MakeFourCC('A', 'C', 'S', 'T'); //NavAreaCost per area id
+		constexpr std::uint32_t offMeshLinks = MakeFourCC('O', 'L', 'N', 'K'); //NavOffMeshLink[]
+
+		//reachability, see NavIslands.h
+		constexpr std::uint32_t polyIslands = MakeFourCC('P', 'I', 'S', 'L'); //uint32 per poly, polys in different islands never reach each other
+		constexpr std::uint32_t polyComponents = MakeFourCC('P', 'S', 'C', 'C'); //uint32 per poly, polys in the same component reach each other both ways
+		constexpr std::uint32_t triangleIslands = MakeFourCC('T', 'I', 'S', 'L'); //uint32 per triangle, the island of its source poly
+		constexpr std::uint32_t triangleComponents = MakeFourCC('T', 'S', 'C', 'C'); //uint32 per triangle, the component of its source poly
+
+		//abstract graph for hierarchical path finding, see NavHierarchy.h
+		constexpr std::uint32_t clusterNodes = MakeFourCC('H', 'N', 'O', 'D'); //uint32 poly per entrance node, sorted by poly
+		constexpr std::uint32_t clusterTiles = MakeFourCC('H', 'T', 'I', 'L'); //uint32 first node per TILE entry, plus the total at the end
+		constexpr std::uint32_t clusterEdgeOffsets = MakeFourCC('H', 'E', 'O', 'F'); //uint32 first edge per node, plus the total at the end
+		constexpr std::uint32_t clusterEdges = MakeFourCC('H', 'E', 'D', 'G'); //NavClusterEdge[]
+
+		//ALT heuristic tables, see NavLandmarks.h
+		constexpr std::uint32_t landmarkHeader = MakeFourCC('L', 'H', 'D', 'R'); //one NavLandmarkHeader
+		constexpr std::uint32_t landmarkPolys = MakeFourCC('L', 'P', 'O', 'L'); //uint32 poly per landmark
+		constexpr std::uint32_t landmarkFromDistances = MakeFourCC('L', 'F', 'W', 'D'); //uint16 per poly and landmark, landmark to poly
+		constexpr std::uint32_t landmarkToDistances = MakeFourCC('L', 'B', 'W', 'D'); //uint16 per poly and landmark, poly to landmark
+	}
+
+	struct NavBinaryHeader
+	{
+		std::uint32_t myMagic;
+		std::uint32_t myVersion;
+		std::uint32_t myFlags;
+		std::uint32_t mySectionCount;
+		std::uint64_t myFileSize;
+		std::uint64_t myChecksum; //Fnv1a64
+	};
+	static_assert(sizeof(NavBinaryHeader) == 32, "NavBinaryHeader layout changed");
+
+	struct NavBinarySection
+	{
+		std::uint32_t myId;
+		std::uint32_t myReserved;
+		std::uint64_t myOffset;
+		std::uint64_t mySize;
+	};
+	static_assert(sizeof(NavBinarySection) == 24, "NavBinarySection layout changed");
+
+	struct NavBinaryTile
+	{
+		std::int32_t myX;
+		std::int32_t myY;
+		std::int32_t myLayer;
+		std::uint32_t myFirstVertex;
+		std::uint32_t myVertexCount;
+		std::uint32_t myFirstIndex;
+		std::uint32_t myIndexCount;
+		std::uint32_t myReserved;
+		float myBoundsMin[3]; //of every vertex the tile's triangles use, metronome axis layout
+		float myBoundsMax[3];
+	};
+	static_assert(sizeof(NavBinaryTile) == 56, "NavBinaryTile layout changed");
+
+	//the container is shared with other exported binaries, they tell themselves apart by magic
+	class NavBinaryWriter
+	{
+	public:
+		explicit NavBinaryWriter(std::uint32_t aMagic = navBinaryMagic) : myMagic(aMagic) {}
+
+		void AddSection(std::uint32_t anId, const void* someData, size_t aSize);
+		template <typename T>
+		void AddSection(std::uint32_t anId, const std::vector<T>& someItems) { AddSection(anId, someItems.data(), someItems.size() * sizeof(T)); }
+
+		void SetFlags(std::uint32_t aFlags) { myFlags |= aFlags; }
+
+		//serializes header, section table and payloads into one buffer
+		std::vector<unsigned char> Build() const;
+		bool Write(const std::string& aPath) const;
+
+	private:
+		struct Section
+		{
+			std::uint32_t myId;
+			std::vector<unsigned char> myData;
+		};
+
+		std::vector<Section> mySections;
+		std::uint32_t myMagic;
+		std::uint32_t myFlags = 0;
+	};
+
+	//validated, read only view over a loaded or mapped nav binary
+	class NavBinaryView
+	{
+	public:
+		//checks magic, version, size and checksum
+		bool Init(const void* someData, size_t aSize, std::uint32_t aMagic = navBinaryMagic);
+
+		const NavBinaryHeader& GetHeader() const { return *myHeader; }
+		//returns nullptr if the file has no such section
+		const void* FindSection(std::uint32_t anId, size_t* aSizeOut = nullptr) const;
+
+	private:
+		const unsigned char* myData = nullptr;
+		const NavBinaryHeader* myHeader = nullptr;
+		const NavBinarySection* mySections = nullptr;
+	};
+
+	//adds the tile table, positions and indices of a merged nav mesh.
+	//compressed, positions are quantized to 16 bits per axis inside their tile's bounds and indices are stored as
+	//zigzag varint deltas, see DecodeNavPositions and DecodeNavIndices
+	void AddNavMeshSections(NavBinaryWriter& aWriter, const NavMesh& aMesh, bool aShouldCompress = false);
+
+	//positions in metronome axis layout from either VPOS or QPOS, empty if the file has neither
+	std::vector<float> DecodeNavPositions(const NavBinaryView& aView);
+	//zero based indices from either INDX or QIDX, empty if the file has neither
+	std::vector<std::uint32_t> DecodeNavIndices(const NavBinaryView& aView);
+}
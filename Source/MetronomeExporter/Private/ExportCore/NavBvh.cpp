@@ -0,0 +1,174 @@
+#include "NavBvh.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace metronome
+{
+	constexpr std::uint32_t maxLeafTriangles = 4;
+
+	struct BvhItem
+	{
+		std::uint32_t myTriangle;
+		float myMin[3];
+		float myMax[3];
+		float myCenter[3];
+	};
+
+	static void Subdivide(std::vector<BvhItem>& someItems, size_t aBegin, size_t anEnd, NavBvh& aBvh)
+	{
+		const size_t nodeIndex = aBvh.myNodes.size();
+		aBvh.myNodes.push_back({});
+		NavBvhNode node;
+		std::fill(node.myMin, node.myMin + 3, std::numeric_limits<float>::max());
+		std::fill(node.myMax, node.myMax + 3, std::numeric_limits<float>::lowest());
+		for (size_t i = aBegin; i < anEnd; ++i)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				node.myMin[axis] = std::min(node.myMin[axis], someItems[i].myMin[axis]);
+				node.myMax[axis] = std::max(node.myMax[axis], someItems[i].myMax[axis]);
+			}
+		}
+
+		if (anEnd - aBegin <= maxLeafTriangles)
+		{
+			node.myIndex = static_cast<std::int32_t>(aBvh.myTriangles.size());
+			node.myCount = static_cast<std::uint32_t>(anEnd - aBegin);
+			for (size_t i = aBegin; i < anEnd; ++i)
+			{
+				aBvh.myTriangles.push_back(someItems[i].myTriangle);
+			}
+			aBvh.myNodes[nodeIndex] = node;
+			return;
+		}
+
+		//median split along the longest axis
+		int splitAxis = 0;
+		for (int axis = 1; axis < 3; ++axis)
+		{
+			if (node.myMax[axis] - node.myMin[axis] > node.myMax[splitAxis] - node.myMin[splitAxis])
+			{
+				splitAxis = axis;
+			}
+		}
+		const size_t middle = aBegin + (anEnd - aBegin) / 2;
+		std::nth_element(someItems.begin() + aBegin, someItems.begin() + middle, someItems.begin() + anEnd, [&](const BvhItem& aA, const BvhItem& aB) {
+			return aA.myCenter[splitAxis] < aB.myCenter[splitAxis];
+		});
+
+		Subdivide(someItems, aBegin, middle, aBvh);
+		Subdivide(someItems, middle, anEnd, aBvh);
+		node.myIndex = -static_cast<std::int32_t>(aBvh.myNodes.size() - nodeIndex);
+		node.myCount = 0;
+		aBvh.myNodes[nodeIndex] = node;
+	}
+
+	NavBvh BuildNavBvh(const NavMesh& aMesh)
+	{
+		std::vector<Vec3> positions;
+		positions.reserve(aMesh.myVertices.size());
+		for (const Vec3& vertex : aMesh.myVertices)
+		{
+			positions.push_back(ToExportVector(vertex));
+		}
+
+		std::vector<BvhItem> items(aMesh.myFaces.size());
+		for (size_t i = 0; i < aMesh.myFaces.size(); ++i)
+		{
+			const Face& face = aMesh.myFaces[i];
+			const Vec3& a = positions[face.x - 1];
+			const Vec3& b = positions[face.y - 1];
+			const Vec3& c = positions[face.z - 1];
+			BvhItem& item = items[i];
+			item.myTriangle = static_cast<std::uint32_t>(i);
+			const float xs[3] = { a.x, b.x, c.x };
+			const float ys[3] = { a.y, b.y, c.y };
+			const float zs[3] = { a.z, b.z, c.z };
+			const float* axes[3] = { xs, ys, zs };
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				item.myMin[axis] = std::min({ axes[axis][0], axes[axis][1], axes[axis][2] });
+				item.myMax[axis] = std::max({ axes[axis][0], axes[axis][1], axes[axis][2] });
+				item.myCenter[axis] = (item.myMin[axis] + item.myMax[axis]) * 0.5f;
+			}
+		}
+
+		NavBvh result;
+		if (!items.empty())
+		{
+			result.myNodes.reserve(items.size() / 2 + 1);
+			result.myTriangles.reserve(items.size());
+			Subdivide(items, 0, items.size(), result);
+		}
+		return result;
+	}
+
+	//height of the triangle at aPoint's x/z, false if aPoint is outside of it seen from above
+	static bool GetTriangleHeight(const float* aA, const float* aB, const float* aC, const float aPoint[3], float& aHeightOut)
+	{
+		const float v0x = aC[0] - aA[0], v0z = aC[2] - aA[2];
+		const float v1x = aB[0] - aA[0], v1z = aB[2] - aA[2];
+		const float v2x = aPoint[0] - aA[0], v2z = aPoint[2] - aA[2];
+		const float denominator = v0x * v1z - v0z * v1x;
+		if (std::abs(denominator) < 1e-12f)
+		{
+			return false;
+		}
+
+		constexpr float edgeTolerance = 1e-4f;
+		const float u = (v1z * v2x - v1x * v2z) / denominator;
+		const float v = (v0x * v2z - v0z * v2x) / denominator;
+		if (u < -edgeTolerance || v < -edgeTolerance || u + v > 1.0f + edgeTolerance)
+		{
+			return false;
+		}
+		aHeightOut = aA[1] + (aC[1] - aA[1]) * u + (aB[1] - aA[1]) * v;
+		return true;
+	}
+
+	int FindNavTriangle(const std::vector<NavBvhNode>& someNodes, const std::uint32_t* someTriangles, const float* somePositions,
+		const std::uint32_t* someIndices, const float aPoint[3], float aMaxHeight, float* aHeightOut)
+	{
+		int best = -1;
+		float bestDistance = aMaxHeight;
+		size_t i = 0;
+		while (i < someNodes.size())
+		{
+			const NavBvhNode& node = someNodes[i];
+			const bool overlaps = aPoint[0] >= node.myMin[0] && aPoint[0] <= node.myMax[0]
+				&& aPoint[2] >= node.myMin[2] && aPoint[2] <= node.myMax[2]
+				&& aPoint[1] >= node.myMin[1] - bestDistance && aPoint[1] <= node.myMax[1] + bestDistance;
+			const bool isLeaf = node.myIndex >= 0;
+
+			if (overlaps && isLeaf)
+			{
+				for (std::uint32_t j = 0; j < node.myCount; ++j)
+				{
+					const std::uint32_t triangle = someTriangles[node.myIndex + j];
+					const std::uint32_t* indices = &someIndices[triangle * 3];
+					float height = 0.0f;
+					if (GetTriangleHeight(&somePositions[indices[0] * 3], &somePositions[indices[1] * 3], &somePositions[indices[2] * 3], aPoint, height)
+						&& std::abs(height - aPoint[1]) <= bestDistance)
+					{
+						best = static_cast<int>(triangle);
+						bestDistance = std::abs(height - aPoint[1]);
+						if (aHeightOut != nullptr)
+						{
+							*aHeightOut = height;
+						}
+					}
+				}
+			}
+
+			i += overlaps || isLeaf ? 1 : static_cast<size_t>(-node.myIndex);
+		}
+		return best;
+	}
+
+	void AddNavBvhSections(NavBinaryWriter& aWriter, const NavBvh& aBvh)
+	{
+		aWriter.AddSection(NavSection::bvhNodes, aBvh.myNodes);
+		aWriter.AddSection(NavSection::bvhTriangles, aBvh.myTriangles);
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "NavBinary.h"
+#include "NavMesh.h"
+#include <cstdint>
+#include <vector>
+
+//flat bounding volume hierarchy over the exported nav triangles, in metronome axis layout (y up).
+//nodes are stored depth first like detour's dtBVNode, so a query walks them front to back without a stack:
+//entering a node moves to the next one, skipping it moves past its whole subtree
+namespace metronome
+{
+	struct NavBvhNode
+	{
+		float myMin[3];
+		float myMax[3];
+		std::int32_t myIndex; //leaf: first slot in BVHT, inner node: minus the size of its subtree in nodes
+		std::uint32_t myCount; //triangles in a leaf, 0 for inner nodes
+	};
+	static_assert(sizeof(NavBvhNode) == 32, "NavBvhNode layout changed");
+
+	struct NavBvh
+	{
+		std::vector<NavBvhNode> myNodes;
+		std::vector<std::uint32_t> myTriangles;
+	};
+
+	NavBvh BuildNavBvh(const NavMesh& aMesh);
+
+	//finds the triangle below or above aPoint closest in height, within aMaxHeight.
+	//returns the triangle index or -1, aHeightOut receives the surface height at aPoint.
+	//somePositions and someIndices are the VPOS and INDX contents, zero based
+	int FindNavTriangle(const std::vector<NavBvhNode>& someNodes, const std::uint32_t* someTriangles, const float* somePositions,
+		const std::uint32_t* someIndices, const float aPoint[3], float aMaxHeight, float* aHeightOut = nullptr);
+
+	void AddNavBvhSections(NavBinaryWriter& aWriter, const NavBvh& aBvh);
+}
@@ -0,0 +1,135 @@
+#include "NavChunks.h"
+#include "FabJson.h"
+#include "NavBinary.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace metronome
+{
+	static int FloorDiv(int aValue, int aDivisor)
+	{
+		return aValue >= 0 ? aValue / aDivisor : -((-aValue + aDivisor - 1) / aDivisor);
+	}
+
+	std::vector<NavChunk> SplitNavMesh(const NavMesh& aMesh, int aTilesPerChunk)
+	{
+		const int tilesPerChunk = std::max(aTilesPerChunk, 1);
+		std::map<std::pair<int, int>, std::vector<const NavTile*>> chunkTiles;
+		for (const NavTile& tile : aMesh.myTiles)
+		{
+			chunkTiles[{ FloorDiv(tile.myY, tilesPerChunk), FloorDiv(tile.myX, tilesPerChunk) }].push_back(&tile);
+		}
+
+		std::vector<NavChunk> chunks;
+		std::vector<std::uint32_t> vertexChunkCounts(aMesh.myVertices.size(), 0);
+		std::vector<std::int64_t> localVertices(aMesh.myVertices.size(), -1);
+		for (const auto& entry : chunkTiles)
+		{
+			NavChunk chunk;
+			chunk.myY = entry.first.first;
+			chunk.myX = entry.first.second;
+			std::vector<std::uint32_t> globalVertices;
+			for (const NavTile* tile : entry.second)
+			{
+				NavTile range = *tile;
+				range.myFirstVertex = static_cast<std::uint32_t>(chunk.myMesh.myVertices.size());
+				range.myFirstFace = static_cast<std::uint32_t>(chunk.myMesh.myFaces.size());
+				for (std::uint32_t i = 0; i < tile->myFaceCount; ++i)
+				{
+					const Face& face = aMesh.myFaces[tile->myFirstFace + i];
+					std::uint32_t local[3];
+					const std::uint32_t global[3] = { face.x - 1, face.y - 1, face.z - 1 };
+					for (int j = 0; j < 3; ++j)
+					{
+						std::int64_t& index = localVertices[global[j]];
+						if (index == -1)
+						{
+							index = static_cast<std::int64_t>(chunk.myMesh.myVertices.size());
+							chunk.myMesh.myVertices.push_back(aMesh.myVertices[global[j]]);
+							globalVertices.push_back(global[j]);
+						}
+						local[j] = static_cast<std::uint32_t>(index) + 1;
+					}
+					chunk.myMesh.myFaces.push_back({ local[0], local[1], local[2] });
+					chunk.myMesh.myFacePolys.push_back(tile->myFirstFace + i < aMesh.myFacePolys.size() ? aMesh.myFacePolys[tile->myFirstFace + i] : 0);
+				}
+				range.myVertexCount = static_cast<std::uint32_t>(chunk.myMesh.myVertices.size()) - range.myFirstVertex;
+				range.myFaceCount = tile->myFaceCount;
+				chunk.myMesh.myTiles.push_back(range);
+			}
+
+			//until every chunk is built the stitches hold all chunk vertices, the border ones are picked below
+			for (size_t i = 0; i < globalVertices.size(); ++i)
+			{
+				++vertexChunkCounts[globalVertices[i]];
+				localVertices[globalVertices[i]] = -1;
+				chunk.myStitches.push_back({ static_cast<std::uint32_t>(i), globalVertices[i] });
+			}
+			chunks.push_back(std::move(chunk));
+		}
+
+		for (NavChunk& chunk : chunks)
+		{
+			chunk.myStitches.erase(std::remove_if(chunk.myStitches.begin(), chunk.myStitches.end(), [&](const NavStitch& aStitch) {
+				return vertexChunkCounts[aStitch.myGlobalVertex] < 2;
+			}), chunk.myStitches.end());
+		}
+		return chunks;
+	}
+
+	bool WriteNavChunks(const std::string& aPathNoExt, const std::vector<NavChunk>& someChunks, int aTilesPerChunk, bool aShouldCompress)
+	{
+		const size_t nameStart = aPathNoExt.find_last_of("/\\");
+		const std::string name = nameStart == std::string::npos ? aPathNoExt : aPathNoExt.substr(nameStart + 1);
+
+		bool succeeded = true;
+		nlohmann::json chunksJson = nlohmann::json::array();
+		for (const NavChunk& chunk : someChunks)
+		{
+			const std::string suffix = "_" + std::to_string(chunk.myX) + "_" + std::to_string(chunk.myY) + ".mnav";
+
+			NavBinaryWriter writer;
+			AddNavMeshSections(writer, chunk.myMesh, aShouldCompress);
+			writer.AddSection(NavSection::stitches, chunk.myStitches);
+			const std::vector<unsigned char> data = writer.Build();
+			std::ofstream file(aPathNoExt + suffix, std::ios::binary);
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			succeeded &= static_cast<bool>(file);
+
+			Vec3 boundsMin = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+			Vec3 boundsMax = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+			for (const Vec3& vertex : chunk.myMesh.myVertices)
+			{
+				const Vec3 exportVertex = ToExportVector(vertex);
+				boundsMin = { std::min(boundsMin.x, exportVertex.x), std::min(boundsMin.y, exportVertex.y), std::min(boundsMin.z, exportVertex.z) };
+				boundsMax = { std::max(boundsMax.x, exportVertex.x), std::max(boundsMax.y, exportVertex.y), std::max(boundsMax.z, exportVertex.z) };
+			}
+			if (chunk.myMesh.myVertices.empty())
+			{
+				boundsMin = boundsMax = { 0.0f, 0.0f, 0.0f };
+			}
+
+			nlohmann::json chunkJson;
+			chunkJson["file"] = name + suffix;
+			chunkJson["x"] = chunk.myX;
+			chunkJson["y"] = chunk.myY;
+			chunkJson["boundsMin"] = CreateVectorJson(boundsMin);
+			chunkJson["boundsMax"] = CreateVectorJson(boundsMax);
+			chunkJson["byteSize"] = data.size();
+			chunkJson["tileCount"] = chunk.myMesh.myTiles.size();
+			chunkJson["vertexCount"] = chunk.myMesh.myVertices.size();
+			chunkJson["triangleCount"] = chunk.myMesh.myFaces.size();
+			chunkJson["stitchCount"] = chunk.myStitches.size();
+			chunksJson.push_back(chunkJson);
+		}
+
+		nlohmann::json manifest;
+		manifest["tilesPerChunk"] = std::max(aTilesPerChunk, 1);
+		manifest["chunks"] = chunksJson;
+		succeeded &= WriteJsonToFile(aPathNoExt + ".chunks.json", manifest, false);
+		return succeeded;
+	}
+}
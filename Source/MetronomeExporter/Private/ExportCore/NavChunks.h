@@ -0,0 +1,32 @@
+#pragma once
+
+#include "NavMesh.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//the merged nav mesh split into chunks of NxN detour tiles, so a runtime can stream nav in and out.
+//every chunk is a nav binary of its own, a json manifest lists them with their bounds and sizes
+namespace metronome
+{
+	//a chunk vertex that other chunks use as well, runtimes join chunks through the global vertex
+	struct NavStitch
+	{
+		std::uint32_t myLocalVertex;
+		std::uint32_t myGlobalVertex; //index in the merged mesh
+	};
+	static_assert(sizeof(NavStitch) == 8, "NavStitch layout changed");
+
+	struct NavChunk
+	{
+		int myX = 0; //tile x / tiles per chunk, rounded down
+		int myY = 0;
+		NavMesh myMesh; //vertices renumbered in first use order within the chunk
+		std::vector<NavStitch> myStitches; //sorted by local vertex
+	};
+
+	std::vector<NavChunk> SplitNavMesh(const NavMesh& aMesh, int aTilesPerChunk);
+
+	//writes <aPathNoExt>_<x>_<y>.mnav per chunk and <aPathNoExt>.chunks.json
+	bool WriteNavChunks(const std::string& aPathNoExt, const std::vector<NavChunk>& someChunks, int aTilesPerChunk, bool aShouldCompress = false);
+}
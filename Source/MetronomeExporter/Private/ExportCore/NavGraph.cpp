@@ -0,0 +1,106 @@
+#include "NavGraph.h"
+
+namespace metronome
+{
+	NavGraph MergeTileGraphs(const std::vector<NavTileGraph>& someTiles)
+	{
+		NavGraph result;
+
+		std::vector<std::uint32_t> tileFirstPolys(someTiles.size(), 0);
+		std::uint32_t polyCount = 0;
+		for (size_t i = 0; i < someTiles.size(); ++i)
+		{
+			if (someTiles[i].myIsValid)
+			{
+				tileFirstPolys[i] = polyCount;
+				result.myFirstPolys.push_back(polyCount);
+				polyCount += static_cast<std::uint32_t>(someTiles[i].myCentroids.size());
+			}
+		}
+		result.myFirstPolys.push_back(polyCount);
+
+		result.myCentroids.reserve(polyCount);
+		result.myLinkOffsets.reserve(polyCount + 1);
+		for (const NavTileGraph& tile : someTiles)
+		{
+			if (!tile.myIsValid)
+			{
+				continue;
+			}
+
+			const std::uint32_t firstPoly = static_cast<std::uint32_t>(result.myCentroids.size());
+			result.myCentroids.insert(result.myCentroids.end(), tile.myCentroids.begin(), tile.myCentroids.end());
+			result.myAreas.insert(result.myAreas.end(), tile.myAreas.begin(), tile.myAreas.end());
+			result.myAreas.resize(result.myCentroids.size(), 0);
+			result.myFlags.insert(result.myFlags.end(), tile.myFlags.begin(), tile.myFlags.end());
+			result.myFlags.resize(result.myCentroids.size(), 0);
+			for (NavOffMeshLink link : tile.myOffMeshLinks)
+			{
+				link.myPoly += firstPoly;
+				result.myOffMeshLinks.push_back(link);
+			}
+			for (size_t poly = 0; poly < tile.myCentroids.size(); ++poly)
+			{
+				result.myLinkOffsets.push_back(static_cast<std::uint32_t>(result.myLinks.size()));
+				for (std::uint32_t link = tile.myLinkOffsets[poly]; link < tile.myLinkOffsets[poly + 1]; ++link)
+				{
+					const NavLinkTarget& target = tile.myLinkTargets[link];
+					if (target.myTile < 0 || static_cast<size_t>(target.myTile) >= someTiles.size()
+						|| !someTiles[target.myTile].myIsValid
+						|| target.myPoly < 0 || static_cast<size_t>(target.myPoly) >= someTiles[target.myTile].myCentroids.size())
+					{
+						continue;
+					}
+					result.myLinks.push_back(tileFirstPolys[target.myTile] + static_cast<std::uint32_t>(target.myPoly));
+					result.myPortals.push_back(tile.myPortals[link * 2]);
+					result.myPortals.push_back(tile.myPortals[link * 2 + 1]);
+				}
+			}
+		}
+		result.myLinkOffsets.push_back(static_cast<std::uint32_t>(result.myLinks.size()));
+		return result;
+	}
+
+	std::vector<std::uint32_t> GetTrianglePolys(const NavGraph& aGraph, const NavMesh& aMesh)
+	{
+		if (aMesh.myFacePolys.size() != aMesh.myFaces.size() || aMesh.myTiles.size() + 1 != aGraph.myFirstPolys.size())
+		{
+			return {};
+		}
+
+		std::vector<std::uint32_t> result(aMesh.myFaces.size(), 0);
+		for (size_t tile = 0; tile < aMesh.myTiles.size(); ++tile)
+		{
+			const NavTile& range = aMesh.myTiles[tile];
+			for (std::uint32_t face = range.myFirstFace; face < range.myFirstFace + range.myFaceCount; ++face)
+			{
+				const std::uint32_t poly = aGraph.myFirstPolys[tile] + aMesh.myFacePolys[face];
+				result[face] = poly < aGraph.myFirstPolys[tile + 1] ? poly : aGraph.myFirstPolys[tile];
+			}
+		}
+		return result;
+	}
+
+	static std::vector<float> ToExportPositions(const std::vector<Vec3>& someVertices)
+	{
+		std::vector<float> positions;
+		positions.reserve(someVertices.size() * 3);
+		for (const Vec3& vertex : someVertices)
+		{
+			const Vec3 exportVertex = ToExportVector(vertex);
+			positions.push_back(exportVertex.x);
+			positions.push_back(exportVertex.y);
+			positions.push_back(exportVertex.z);
+		}
+		return positions;
+	}
+
+	void AddNavGraphSections(NavBinaryWriter& aWriter, const NavGraph& aGraph)
+	{
+		aWriter.AddSection(NavSection::polyTiles, aGraph.myFirstPolys);
+		aWriter.AddSection(NavSection::polyCentroids, ToExportPositions(aGraph.myCentroids));
+		aWriter.AddSection(NavSection::polyLinkOffsets, aGraph.myLinkOffsets);
+		aWriter.AddSection(NavSection::polyLinks, aGraph.myLinks);
+		aWriter.AddSection(NavSection::polyPortals, ToExportPositions(aGraph.myPortals));
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ExportMath.h"
+#include "NavBinary.h"
+#include "NavMesh.h"
+#include <cstdint>
+#include <vector>
+
+namespace metronome
+{
+	//a link target as detour addresses it, the tile is the tile slot index in the dtNavMesh
+	struct NavLinkTarget
+	{
+		int myTile;
+		int myPoly;
+	};
+
+	//an off-mesh connection, a jump or drop the agent can take between two points
+	struct NavOffMeshLink
+	{
+		float myStart[3]; //unreal space in tile graphs, metronome axis layout once written
+		float myEnd[3];
+		float myRadius;
+		std::uint32_t myPoly; //the connection's own poly, within the tile in tile graphs and global in NavGraph
+		std::uint32_t myFlags; //NavOffMeshLinkFlags
+		std::uint32_t myReserved;
+		std::uint64_t myUserId;
+	};
+	static_assert(sizeof(NavOffMeshLink) == 48, "NavOffMeshLink layout changed");
+
+	namespace NavOffMeshLinkFlags
+	{
+		constexpr std::uint32_t bidirectional = 1 << 0; //otherwise only start to end
+	}
+
+	//adjacency of the polys in one detour tile, built independently of the other tiles
+	struct NavTileGraph
+	{
+		bool myIsValid = false; //false for unused tile slots, must match the tile's NavTileMesh
+		std::vector<Vec3> myCentroids; //per poly, unreal space
+		std::vector<std::uint8_t> myAreas; //detour area id per poly
+		std::vector<std::uint16_t> myFlags; //detour poly flags per poly
+		std::vector<NavOffMeshLink> myOffMeshLinks;
+		std::vector<std::uint32_t> myLinkOffsets; //first link per poly, plus the link count at the end
+		std::vector<NavLinkTarget> myLinkTargets;
+		std::vector<Vec3> myPortals; //two per link, unreal space
+	};
+
+	//flat adjacency of every poly in the nav mesh. polys are numbered tile by tile, so a poly's global index is
+	//myFirstPolys[tile] + its index in the detour tile
+	struct NavGraph
+	{
+		std::vector<std::uint32_t> myFirstPolys; //per valid tile, plus the poly count at the end
+		std::vector<Vec3> myCentroids;
+		std::vector<std::uint8_t> myAreas;
+		std::vector<std::uint16_t> myFlags;
+		std::vector<std::uint32_t> myLinkOffsets;
+		std::vector<std::uint32_t> myLinks;
+		std::vector<Vec3> myPortals;
+		std::vector<NavOffMeshLink> myOffMeshLinks;
+	};
+
+	//resolves detour tile/poly targets to global poly indices, links to missing tiles are dropped
+	NavGraph MergeTileGraphs(const std::vector<NavTileGraph>& someTiles);
+
+	//the global poly of every triangle in aMesh through its source poly, aMesh must come from the same tiles as aGraph.
+	//empty if the mesh doesn't know its source polys
+	std::vector<std::uint32_t> GetTrianglePolys(const NavGraph& aGraph, const NavMesh& aMesh);
+
+	void AddNavGraphSections(NavBinaryWriter& aWriter, const NavGraph& aGraph);
+}
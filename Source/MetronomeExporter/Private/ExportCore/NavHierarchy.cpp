@@ -0,0 +1,156 @@
+#include "NavHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace metronome
+{
+	static float Distance(const Vec3& aA, const Vec3& aB)
+	{
+		const float dx = aA.x - aB.x;
+		const float dy = aA.y - aB.y;
+		const float dz = aA.z - aB.z;
+		return std::sqrt(dx * dx + dy * dy + dz * dz);
+	}
+
+	float GetNavLinkCost(const NavGraph& aGraph, std::uint32_t aPoly, std::uint32_t aLink)
+	{
+		const Vec3& left = aGraph.myPortals[aLink * 2];
+		const Vec3& right = aGraph.myPortals[aLink * 2 + 1];
+		const Vec3 portalMid = { (left.x + right.x) * 0.5f, (left.y + right.y) * 0.5f, (left.z + right.z) * 0.5f };
+		return Distance(aGraph.myCentroids[aPoly], portalMid) + Distance(portalMid, aGraph.myCentroids[aGraph.myLinks[aLink]]);
+	}
+
+	NavClusterGraph BuildClusterGraph(const NavGraph& aGraph, const ParallelForFn& aParallelFor)
+	{
+		NavClusterGraph result;
+		const std::uint32_t polyCount = static_cast<std::uint32_t>(aGraph.myCentroids.size());
+		const int tileCount = static_cast<int>(aGraph.myFirstPolys.size()) - 1;
+
+		std::vector<std::uint32_t> polyTiles(polyCount);
+		for (int tile = 0; tile < tileCount; ++tile)
+		{
+			std::fill(polyTiles.begin() + aGraph.myFirstPolys[tile], polyTiles.begin() + aGraph.myFirstPolys[tile + 1], static_cast<std::uint32_t>(tile));
+		}
+
+		//both ends of a link between tiles are entrances, one way off-mesh links don't link back from where they land
+		std::vector<char> isEntrance(polyCount, 0);
+		for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+		{
+			for (std::uint32_t link = aGraph.myLinkOffsets[poly]; link < aGraph.myLinkOffsets[poly + 1]; ++link)
+			{
+				const std::uint32_t target = aGraph.myLinks[link];
+				if (polyTiles[target] != polyTiles[poly])
+				{
+					isEntrance[poly] = 1;
+					isEntrance[target] = 1;
+				}
+			}
+		}
+
+		//polys are numbered tile by tile, so nodes come out grouped by tile as well
+		constexpr std::uint32_t noNode = std::numeric_limits<std::uint32_t>::max();
+		std::vector<std::uint32_t> polyNodes(polyCount, noNode);
+		for (int tile = 0; tile < tileCount; ++tile)
+		{
+			result.myFirstNodes.push_back(static_cast<std::uint32_t>(result.myNodePolys.size()));
+			for (std::uint32_t poly = aGraph.myFirstPolys[tile]; poly < aGraph.myFirstPolys[tile + 1]; ++poly)
+			{
+				if (isEntrance[poly] != 0)
+				{
+					polyNodes[poly] = static_cast<std::uint32_t>(result.myNodePolys.size());
+					result.myNodePolys.push_back(poly);
+				}
+			}
+		}
+		result.myFirstNodes.push_back(static_cast<std::uint32_t>(result.myNodePolys.size()));
+
+		//every tile only writes the edges of its own nodes
+		std::vector<std::vector<NavClusterEdge>> nodeEdges(result.myNodePolys.size());
+		RunParallelFor(aParallelFor, tileCount, [&](int aTile) {
+			const std::uint32_t firstPoly = aGraph.myFirstPolys[aTile];
+			const std::uint32_t tilePolyCount = aGraph.myFirstPolys[aTile + 1] - firstPoly;
+			std::vector<float> costs(tilePolyCount);
+			using QueueItem = std::pair<float, std::uint32_t>;
+			std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> open;
+
+			for (std::uint32_t node = result.myFirstNodes[aTile]; node < result.myFirstNodes[aTile + 1]; ++node)
+			{
+				const std::uint32_t startPoly = result.myNodePolys[node];
+				std::vector<NavClusterEdge>& edges = nodeEdges[node];
+
+				//links leaving the tile
+				for (std::uint32_t link = aGraph.myLinkOffsets[startPoly]; link < aGraph.myLinkOffsets[startPoly + 1]; ++link)
+				{
+					const std::uint32_t target = aGraph.myLinks[link];
+					if (polyTiles[target] != static_cast<std::uint32_t>(aTile))
+					{
+						edges.push_back({ polyNodes[target], GetNavLinkCost(aGraph, startPoly, link) });
+					}
+				}
+
+				//dijkstra limited to the tile, to every other entrance of it
+				std::fill(costs.begin(), costs.end(), std::numeric_limits<float>::infinity());
+				costs[startPoly - firstPoly] = 0.0f;
+				open.push({ 0.0f, startPoly });
+				while (!open.empty())
+				{
+					const QueueItem item = open.top();
+					open.pop();
+					const std::uint32_t poly = item.second;
+					if (item.first > costs[poly - firstPoly])
+					{
+						continue;
+					}
+					if (poly != startPoly && polyNodes[poly] != noNode)
+					{
+						edges.push_back({ polyNodes[poly], item.first });
+					}
+
+					for (std::uint32_t link = aGraph.myLinkOffsets[poly]; link < aGraph.myLinkOffsets[poly + 1]; ++link)
+					{
+						const std::uint32_t target = aGraph.myLinks[link];
+						if (polyTiles[target] != static_cast<std::uint32_t>(aTile))
+						{
+							continue;
+						}
+						const float cost = item.first + GetNavLinkCost(aGraph, poly, link);
+						if (cost < costs[target - firstPoly])
+						{
+							costs[target - firstPoly] = cost;
+							open.push({ cost, target });
+						}
+					}
+				}
+
+				//several links can join the same pair of polys, keep the cheapest
+				std::sort(edges.begin(), edges.end(), [](const NavClusterEdge& aA, const NavClusterEdge& aB) {
+					return aA.myTarget != aB.myTarget ? aA.myTarget < aB.myTarget : aA.myCost < aB.myCost;
+				});
+				edges.erase(std::unique(edges.begin(), edges.end(), [](const NavClusterEdge& aA, const NavClusterEdge& aB) {
+					return aA.myTarget == aB.myTarget;
+				}), edges.end());
+			}
+		});
+
+		result.myEdgeOffsets.reserve(nodeEdges.size() + 1);
+		for (const std::vector<NavClusterEdge>& edges : nodeEdges)
+		{
+			result.myEdgeOffsets.push_back(static_cast<std::uint32_t>(result.myEdges.size()));
+			result.myEdges.insert(result.myEdges.end(), edges.begin(), edges.end());
+		}
+		result.myEdgeOffsets.push_back(static_cast<std::uint32_t>(result.myEdges.size()));
+		return result;
+	}
+
+	void AddNavClusterGraphSections(NavBinaryWriter& aWriter, const NavClusterGraph& aClusterGraph)
+	{
+		aWriter.AddSection(NavSection::clusterNodes, aClusterGraph.myNodePolys);
+		aWriter.AddSection(NavSection::clusterTiles, aClusterGraph.myFirstNodes);
+		aWriter.AddSection(NavSection::clusterEdgeOffsets, aClusterGraph.myEdgeOffsets);
+		aWriter.AddSection(NavSection::clusterEdges, aClusterGraph.myEdges);
+	}
+}
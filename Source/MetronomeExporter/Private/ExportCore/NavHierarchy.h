@@ -0,0 +1,37 @@
+#pragma once
+
+#include "NavGraph.h"
+#include "Parallel.h"
+#include <cstdint>
+#include <vector>
+
+//hierarchical path finding (HPA*) over the tiles of a nav graph.
+//every poly with a link into or out of another tile is an entrance node. nodes in the same tile are connected by the cost of
+//the cheapest path that stays inside the tile, nodes in different tiles by the link between them.
+//a query connects start and goal to the entrance nodes of their own tiles, searches the node graph and refines
+//each abstract edge with a search limited to one tile
+namespace metronome
+{
+	struct NavClusterEdge
+	{
+		std::uint32_t myTarget; //node index
+		float myCost;
+	};
+	static_assert(sizeof(NavClusterEdge) == 8, "NavClusterEdge layout changed");
+
+	struct NavClusterGraph
+	{
+		std::vector<std::uint32_t> myNodePolys;
+		std::vector<std::uint32_t> myFirstNodes; //per tile, plus the node count at the end
+		std::vector<std::uint32_t> myEdgeOffsets; //first edge per node, plus the edge count at the end
+		std::vector<NavClusterEdge> myEdges; //per node sorted by target
+	};
+
+	//cost of crossing a link, centroid to portal midpoint to centroid, in unreal units
+	float GetNavLinkCost(const NavGraph& aGraph, std::uint32_t aPoly, std::uint32_t aLink);
+
+	//tiles are searched independently, concurrently when aParallelFor is given
+	NavClusterGraph BuildClusterGraph(const NavGraph& aGraph, const ParallelForFn& aParallelFor = {});
+
+	void AddNavClusterGraphSections(NavBinaryWriter& aWriter, const NavClusterGraph& aClusterGraph);
+}
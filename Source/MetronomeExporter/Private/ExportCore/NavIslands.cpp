@@ -0,0 +1,159 @@
+#include "NavIslands.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace metronome
+{
+	static std::uint32_t FindRoot(std::vector<std::uint32_t>& someParents, std::uint32_t aPoly)
+	{
+		while (someParents[aPoly] != aPoly)
+		{
+			someParents[aPoly] = someParents[someParents[aPoly]];
+			aPoly = someParents[aPoly];
+		}
+		return aPoly;
+	}
+
+	//union-find over every link regardless of direction
+	static std::vector<std::uint32_t> FindIslands(const NavGraph& aGraph)
+	{
+		const std::uint32_t polyCount = static_cast<std::uint32_t>(aGraph.myCentroids.size());
+		std::vector<std::uint32_t> parents(polyCount);
+		std::iota(parents.begin(), parents.end(), 0u);
+		for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+		{
+			for (std::uint32_t link = aGraph.myLinkOffsets[poly]; link < aGraph.myLinkOffsets[poly + 1]; ++link)
+			{
+				const std::uint32_t a = FindRoot(parents, poly);
+				const std::uint32_t b = FindRoot(parents, aGraph.myLinks[link]);
+				//the lower root wins so every root is the lowest poly of its island
+				parents[std::max(a, b)] = std::min(a, b);
+			}
+		}
+
+		constexpr std::uint32_t unlabelled = std::numeric_limits<std::uint32_t>::max();
+		std::vector<std::uint32_t> rootIslands(polyCount, unlabelled);
+		std::vector<std::uint32_t> islands(polyCount);
+		std::uint32_t islandCount = 0;
+		for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+		{
+			std::uint32_t& island = rootIslands[FindRoot(parents, poly)];
+			if (island == unlabelled)
+			{
+				island = islandCount++;
+			}
+			islands[poly] = island;
+		}
+		return islands;
+	}
+
+	//tarjan's strongly connected components with an explicit stack, the graph is far too deep for recursion
+	static std::vector<std::uint32_t> FindComponents(const NavGraph& aGraph)
+	{
+		const std::uint32_t polyCount = static_cast<std::uint32_t>(aGraph.myCentroids.size());
+		constexpr std::uint32_t unvisited = std::numeric_limits<std::uint32_t>::max();
+		std::vector<std::uint32_t> order(polyCount, unvisited);
+		std::vector<std::uint32_t> lowLinks(polyCount, 0);
+		std::vector<std::uint32_t> components(polyCount, unvisited);
+		std::vector<std::uint32_t> stack;
+		struct Frame
+		{
+			std::uint32_t myPoly;
+			std::uint32_t myNextLink;
+		};
+		std::vector<Frame> frames;
+		std::uint32_t visitCount = 0;
+		std::uint32_t componentCount = 0;
+
+		for (std::uint32_t start = 0; start < polyCount; ++start)
+		{
+			if (order[start] != unvisited)
+			{
+				continue;
+			}
+
+			order[start] = lowLinks[start] = visitCount++;
+			stack.push_back(start);
+			frames.push_back({ start, aGraph.myLinkOffsets[start] });
+			while (!frames.empty())
+			{
+				Frame& frame = frames.back();
+				const std::uint32_t poly = frame.myPoly;
+				if (frame.myNextLink < aGraph.myLinkOffsets[poly + 1])
+				{
+					const std::uint32_t target = aGraph.myLinks[frame.myNextLink++];
+					if (order[target] == unvisited)
+					{
+						order[target] = lowLinks[target] = visitCount++;
+						stack.push_back(target);
+						frames.push_back({ target, aGraph.myLinkOffsets[target] });
+					}
+					else if (components[target] == unvisited)
+					{
+						lowLinks[poly] = std::min(lowLinks[poly], order[target]);
+					}
+					continue;
+				}
+
+				if (lowLinks[poly] == order[poly])
+				{
+					std::uint32_t member;
+					do
+					{
+						member = stack.back();
+						stack.pop_back();
+						components[member] = componentCount;
+					} while (member != poly);
+					++componentCount;
+				}
+				frames.pop_back();
+				if (!frames.empty())
+				{
+					lowLinks[frames.back().myPoly] = std::min(lowLinks[frames.back().myPoly], lowLinks[poly]);
+				}
+			}
+		}
+
+		//tarjan numbers components in completion order, renumber them by their lowest poly
+		std::vector<std::uint32_t> renumbered(componentCount, unvisited);
+		std::uint32_t nextId = 0;
+		for (std::uint32_t& component : components)
+		{
+			if (renumbered[component] == unvisited)
+			{
+				renumbered[component] = nextId++;
+			}
+			component = renumbered[component];
+		}
+		return components;
+	}
+
+	NavIslands BuildNavIslands(const NavGraph& aGraph, const NavMesh& aMesh)
+	{
+		NavIslands result;
+		result.myPolyIslands = FindIslands(aGraph);
+		result.myPolyComponents = FindComponents(aGraph);
+
+		const std::vector<std::uint32_t> trianglePolys = GetTrianglePolys(aGraph, aMesh);
+		result.myTriangleIslands.reserve(trianglePolys.size());
+		result.myTriangleComponents.reserve(trianglePolys.size());
+		for (std::uint32_t poly : trianglePolys)
+		{
+			result.myTriangleIslands.push_back(result.myPolyIslands[poly]);
+			result.myTriangleComponents.push_back(result.myPolyComponents[poly]);
+		}
+		return result;
+	}
+
+	void AddNavIslandSections(NavBinaryWriter& aWriter, const NavIslands& someIslands)
+	{
+		aWriter.AddSection(NavSection::polyIslands, someIslands.myPolyIslands);
+		aWriter.AddSection(NavSection::polyComponents, someIslands.myPolyComponents);
+		if (!someIslands.myTriangleIslands.empty())
+		{
+			aWriter.AddSection(NavSection::triangleIslands, someIslands.myTriangleIslands);
+			aWriter.AddSection(NavSection::triangleComponents, someIslands.myTriangleComponents);
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "NavBinary.h"
+#include "NavGraph.h"
+#include "NavMesh.h"
+#include <cstdint>
+#include <vector>
+
+//reachability labels over the poly graph, so most "can a reach b" questions are a compare instead of a failed search.
+//islands ignore link direction: different islands never reach each other.
+//components respect it (one-way off-mesh links): the same component always reaches both ways.
+//only polys in the same island but different components need a search
+namespace metronome
+{
+	struct NavIslands
+	{
+		std::vector<std::uint32_t> myPolyIslands;
+		std::vector<std::uint32_t> myPolyComponents;
+		std::vector<std::uint32_t> myTriangleIslands; //empty if aMesh has no source polys
+		std::vector<std::uint32_t> myTriangleComponents;
+	};
+
+	//ids are numbered in order of the lowest poly they contain.
+	//aMesh must come from the same tiles as aGraph, its triangles are labelled through their source polys
+	NavIslands BuildNavIslands(const NavGraph& aGraph, const NavMesh& aMesh);
+
+	void AddNavIslandSections(NavBinaryWriter& aWriter, const NavIslands& someIslands);
+}
@@ -0,0 +1,200 @@
+#include "NavLandmarks.h"
+#include "NavHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace metronome
+{
+	//costs from aStart over the given csr adjacency, someCosts[link] is the cost of link
+	static std::vector<float> FindCosts(const std::vector<std::uint32_t>& someOffsets, const std::vector<std::uint32_t>& someTargets,
+		const std::vector<float>& someLinkCosts, std::uint32_t aStart)
+	{
+		std::vector<float> costs(someOffsets.size() - 1, std::numeric_limits<float>::infinity());
+		using QueueItem = std::pair<float, std::uint32_t>;
+		std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> open;
+		costs[aStart] = 0.0f;
+		open.push({ 0.0f, aStart });
+		while (!open.empty())
+		{
+			const QueueItem item = open.top();
+			open.pop();
+			if (item.first > costs[item.second])
+			{
+				continue;
+			}
+			for (std::uint32_t link = someOffsets[item.second]; link < someOffsets[item.second + 1]; ++link)
+			{
+				const float cost = item.first + someLinkCosts[link];
+				if (cost < costs[someTargets[link]])
+				{
+					costs[someTargets[link]] = cost;
+					open.push({ cost, someTargets[link] });
+				}
+			}
+		}
+		return costs;
+	}
+
+	NavLandmarks BuildNavLandmarks(const NavGraph& aGraph, int aLandmarkCount, const ParallelForFn& aParallelFor)
+	{
+		NavLandmarks result;
+		const std::uint32_t polyCount = static_cast<std::uint32_t>(aGraph.myCentroids.size());
+		if (polyCount == 0 || aLandmarkCount <= 0)
+		{
+			return result;
+		}
+
+		std::vector<float> linkCosts(aGraph.myLinks.size());
+		for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+		{
+			for (std::uint32_t link = aGraph.myLinkOffsets[poly]; link < aGraph.myLinkOffsets[poly + 1]; ++link)
+			{
+				linkCosts[link] = GetNavLinkCost(aGraph, poly, link);
+			}
+		}
+
+		//links turned around, for the costs towards a landmark
+		std::vector<std::uint32_t> reverseOffsets(polyCount + 1, 0);
+		for (std::uint32_t target : aGraph.myLinks)
+		{
+			++reverseOffsets[target + 1];
+		}
+		for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+		{
+			reverseOffsets[poly + 1] += reverseOffsets[poly];
+		}
+		std::vector<std::uint32_t> reverseTargets(aGraph.myLinks.size());
+		std::vector<float> reverseCosts(aGraph.myLinks.size());
+		std::vector<std::uint32_t> fill(reverseOffsets.begin(), reverseOffsets.end() - 1);
+		for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+		{
+			for (std::uint32_t link = aGraph.myLinkOffsets[poly]; link < aGraph.myLinkOffsets[poly + 1]; ++link)
+			{
+				const std::uint32_t slot = fill[aGraph.myLinks[link]]++;
+				reverseTargets[slot] = poly;
+				reverseCosts[slot] = linkCosts[link];
+			}
+		}
+
+		//each pick needs the costs from the one before, so selection runs in order
+		std::vector<std::vector<float>> fromCosts;
+		std::vector<float> nearest = FindCosts(aGraph.myLinkOffsets, aGraph.myLinks, linkCosts, 0);
+		for (int i = 0; i < aLandmarkCount && static_cast<std::uint32_t>(i) < polyCount; ++i)
+		{
+			std::uint32_t farthest = 0;
+			for (std::uint32_t poly = 1; poly < polyCount; ++poly)
+			{
+				if (nearest[poly] > nearest[farthest])
+				{
+					farthest = poly;
+				}
+			}
+			if (i > 0 && nearest[farthest] == 0.0f)
+			{
+				break;
+			}
+
+			result.myPolys.push_back(farthest);
+			fromCosts.push_back(FindCosts(aGraph.myLinkOffsets, aGraph.myLinks, linkCosts, farthest));
+			if (i == 0)
+			{
+				nearest = fromCosts.back();
+			}
+			else
+			{
+				for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+				{
+					nearest[poly] = std::min(nearest[poly], fromCosts.back()[poly]);
+				}
+			}
+		}
+
+		const size_t landmarkCount = result.myPolys.size();
+		std::vector<std::vector<float>> toCosts(landmarkCount);
+		RunParallelFor(aParallelFor, static_cast<int>(landmarkCount), [&](int aLandmark) {
+			toCosts[aLandmark] = FindCosts(reverseOffsets, reverseTargets, reverseCosts, result.myPolys[aLandmark]);
+		});
+
+		float maxCost = 0.0f;
+		for (size_t landmark = 0; landmark < landmarkCount; ++landmark)
+		{
+			for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+			{
+				for (float cost : { fromCosts[landmark][poly], toCosts[landmark][poly] })
+				{
+					if (std::isfinite(cost))
+					{
+						maxCost = std::max(maxCost, cost);
+					}
+				}
+			}
+		}
+		result.myScale = maxCost > 0.0f ? maxCost / (navLandmarkUnreachable - 1) : 1.0f;
+
+		auto quantize = [&](float aCost) {
+			return std::isfinite(aCost) ? static_cast<std::uint16_t>(std::min(std::round(aCost / result.myScale), navLandmarkUnreachable - 1.0f)) : navLandmarkUnreachable;
+		};
+		result.myFromDistances.resize(polyCount * landmarkCount);
+		result.myToDistances.resize(polyCount * landmarkCount);
+		for (std::uint32_t poly = 0; poly < polyCount; ++poly)
+		{
+			for (size_t landmark = 0; landmark < landmarkCount; ++landmark)
+			{
+				result.myFromDistances[poly * landmarkCount + landmark] = quantize(fromCosts[landmark][poly]);
+				result.myToDistances[poly * landmarkCount + landmark] = quantize(toCosts[landmark][poly]);
+			}
+		}
+		return result;
+	}
+
+	float GetNavLandmarkBound(const NavLandmarks& someLandmarks, std::uint32_t aFromPoly, std::uint32_t aToPoly)
+	{
+		const size_t landmarkCount = someLandmarks.myPolys.size();
+		const std::uint16_t* fromA = &someLandmarks.myFromDistances[aFromPoly * landmarkCount];
+		const std::uint16_t* fromB = &someLandmarks.myFromDistances[aToPoly * landmarkCount];
+		const std::uint16_t* toA = &someLandmarks.myToDistances[aFromPoly * landmarkCount];
+		const std::uint16_t* toB = &someLandmarks.myToDistances[aToPoly * landmarkCount];
+
+		int best = 0;
+		for (size_t i = 0; i < landmarkCount; ++i)
+		{
+			//a landmark that reaches the start but not the goal, or the goal but not from the start, proves there is no path.
+			//a landmark unreachable on both sides says nothing
+			const bool reachesA = fromA[i] != navLandmarkUnreachable;
+			const bool reachesB = fromB[i] != navLandmarkUnreachable;
+			const bool isReachedFromA = toA[i] != navLandmarkUnreachable;
+			const bool isReachedFromB = toB[i] != navLandmarkUnreachable;
+			if ((reachesA && !reachesB) || (isReachedFromB && !isReachedFromA))
+			{
+				return std::numeric_limits<float>::infinity();
+			}
+			if (reachesA && reachesB)
+			{
+				best = std::max(best, fromB[i] - fromA[i]);
+			}
+			if (isReachedFromA && isReachedFromB)
+			{
+				best = std::max(best, toA[i] - toB[i]);
+			}
+		}
+		//each quantized value is off by half a step at most
+		return std::max(0.0f, (best - 1) * someLandmarks.myScale);
+	}
+
+	void AddNavLandmarkSections(NavBinaryWriter& aWriter, const NavLandmarks& someLandmarks)
+	{
+		NavLandmarkHeader header;
+		header.myLandmarkCount = static_cast<std::uint32_t>(someLandmarks.myPolys.size());
+		header.myPolyCount = header.myLandmarkCount > 0 ? static_cast<std::uint32_t>(someLandmarks.myFromDistances.size() / header.myLandmarkCount) : 0;
+		header.myScale = someLandmarks.myScale;
+		header.myReserved = 0;
+		aWriter.AddSection(NavSection::landmarkHeader, &header, sizeof(header));
+		aWriter.AddSection(NavSection::landmarkPolys, someLandmarks.myPolys);
+		aWriter.AddSection(NavSection::landmarkFromDistances, someLandmarks.myFromDistances);
+		aWriter.AddSection(NavSection::landmarkToDistances, someLandmarks.myToDistances);
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "NavBinary.h"
+#include "NavGraph.h"
+#include "Parallel.h"
+#include <cstdint>
+#include <vector>
+
+//landmark (ALT) lower bounds for A* over the poly graph. with d the shortest path cost between polys,
+//for every landmark l: d(a, b) >= d(l, b) - d(l, a) and d(a, b) >= d(a, l) - d(b, l).
+//distances are quantized to 16 bits, value * myScale is within one myScale of the true cost, so a runtime subtracts
+//myScale from the bound to keep it admissible
+namespace metronome
+{
+	constexpr std::uint16_t navLandmarkUnreachable = 0xFFFF;
+
+	struct NavLandmarkHeader
+	{
+		std::uint32_t myLandmarkCount;
+		std::uint32_t myPolyCount;
+		float myScale;
+		std::uint32_t myReserved;
+	};
+	static_assert(sizeof(NavLandmarkHeader) == 16, "NavLandmarkHeader layout changed");
+
+	struct NavLandmarks
+	{
+		std::vector<std::uint32_t> myPolys;
+		float myScale = 1.0f;
+		std::vector<std::uint16_t> myFromDistances; //[poly * landmark count + landmark], landmark to poly
+		std::vector<std::uint16_t> myToDistances; //[poly * landmark count + landmark], poly to landmark
+	};
+
+	//farthest point selection: every landmark is the poly farthest from the ones picked before it,
+	//polys no landmark reaches yet count as farthest so every island gets one. link costs are GetNavLinkCost
+	NavLandmarks BuildNavLandmarks(const NavGraph& aGraph, int aLandmarkCount, const ParallelForFn& aParallelFor = {});
+
+	//the landmark lower bound in unreal units, already made admissible. infinity when a landmark proves there is no path
+	float GetNavLandmarkBound(const NavLandmarks& someLandmarks, std::uint32_t aFromPoly, std::uint32_t aToPoly);
+
+	void AddNavLandmarkSections(NavBinaryWriter& aWriter, const NavLandmarks& someLandmarks);
+}
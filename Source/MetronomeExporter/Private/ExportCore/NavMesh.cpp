@@ -0,0 +1,114 @@
+#include "NavMesh.h"
+#include "Delaunay.h"
+
+namespace metronome
+{
+	NavMeshBuilder::NavMeshBuilder(float aWeldEpsilon)
+		: myWelder(aWeldEpsilon)
+	{
+	}
+
+	int NavMeshBuilder::AddVertex(const Vec3& aVertex)
+	{
+		const int newIndex = static_cast<int>(myMesh.myVertices.size());
+		const int index = myWelder.FindOrInsert(aVertex, newIndex);
+		if (index == newIndex)
+		{
+			myMesh.myVertices.push_back(aVertex);
+		}
+		return index;
+	}
+
+	void NavMeshBuilder::AddTriangle(int aA, int aB, int aC)
+	{
+		//winding is flipped to match metronome's handedness
+		Face face;
+		face.x = aA + 1;
+		face.y = aC + 1;
+		face.z = aB + 1;
+		myMesh.myFaces.push_back(face);
+		myMesh.myFacePolys.push_back(mySourcePoly);
+	}
+
+	void NavMeshBuilder::AddPolygon(const std::vector<Vec3>& someVertices)
+	{
+		//weld once per poly vertex, the triangulation hands back indices into the outline
+		std::vector<int> polygonIndices;
+		std::vector<delaunay::Point<float>> vertexVector;
+		for (const Vec3& vertex : someVertices)
+		{
+			polygonIndices.push_back(AddVertex(vertex));
+			vertexVector.emplace_back(vertex.x, vertex.y, vertex.z);
+		}
+
+		delaunay::Delaunay<float> triangles = delaunay::triangulate<float>(vertexVector);
+		for (const std::array<int, 3>& triangle : triangles.indices)
+		{
+			AddTriangle(polygonIndices[triangle[0]], polygonIndices[triangle[1]], polygonIndices[triangle[2]]);
+		}
+	}
+
+	NavMesh MergeTileMeshes(const std::vector<NavTileMesh>& someTiles, float aWeldEpsilon)
+	{
+		size_t vertexCount = 0;
+		size_t faceCount = 0;
+		for (const NavTileMesh& tile : someTiles)
+		{
+			vertexCount += tile.myMesh.myVertices.size();
+			faceCount += tile.myMesh.myFaces.size();
+		}
+
+		NavMesh result;
+		result.myVertices.reserve(vertexCount);
+		result.myFaces.reserve(faceCount);
+		result.myFacePolys.reserve(faceCount);
+		VertexWelder welder(aWeldEpsilon);
+		welder.Reserve(vertexCount);
+
+		std::vector<std::uint32_t> remap;
+		for (const NavTileMesh& tile : someTiles)
+		{
+			if (!tile.myIsValid)
+			{
+				continue;
+			}
+
+			NavTile range;
+			range.myX = tile.myX;
+			range.myY = tile.myY;
+			range.myLayer = tile.myLayer;
+			range.myFirstVertex = static_cast<std::uint32_t>(result.myVertices.size());
+			range.myFirstFace = static_cast<std::uint32_t>(result.myFaces.size());
+
+			//tile vertices are in first use order, so welding them in order reproduces the serial numbering
+			const NavMesh& mesh = tile.myMesh;
+			remap.resize(mesh.myVertices.size());
+			for (size_t i = 0; i < mesh.myVertices.size(); ++i)
+			{
+				const int newIndex = static_cast<int>(result.myVertices.size());
+				const int index = welder.FindOrInsert(mesh.myVertices[i], newIndex);
+				if (index == newIndex)
+				{
+					result.myVertices.push_back(mesh.myVertices[i]);
+				}
+				remap[i] = static_cast<std::uint32_t>(index);
+			}
+
+			for (const Face& face : mesh.myFaces)
+			{
+				Face merged;
+				merged.x = remap[face.x - 1] + 1;
+				merged.y = remap[face.y - 1] + 1;
+				merged.z = remap[face.z - 1] + 1;
+				result.myFaces.push_back(merged);
+			}
+			result.myFacePolys.insert(result.myFacePolys.end(), mesh.myFacePolys.begin(), mesh.myFacePolys.end());
+			result.myFacePolys.resize(result.myFaces.size(), 0);
+
+			range.myVertexCount = static_cast<std::uint32_t>(result.myVertices.size()) - range.myFirstVertex;
+			range.myFaceCount = static_cast<std::uint32_t>(result.myFaces.size()) - range.myFirstFace;
+			result.myTiles.push_back(range);
+		}
+		return result;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ExportMath.h"
+#include "VertexWelder.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace metronome
+{
+	//one based obj indices
+	struct Face
+	{
+		std::uint32_t x;
+		std::uint32_t y;
+		std::uint32_t z;
+	};
+
+	//range of a merged mesh that came from one detour tile
+	struct NavTile
+	{
+		int myX = 0;
+		int myY = 0;
+		int myLayer = 0;
+		std::uint32_t myFirstVertex = 0; //vertices first used by this tile, border vertices belong to the tile that used them first
+		std::uint32_t myVertexCount = 0;
+		std::uint32_t myFirstFace = 0;
+		std::uint32_t myFaceCount = 0;
+	};
+
+	struct NavMesh
+	{
+		std::vector<Vec3> myVertices;
+		std::vector<Face> myFaces;
+		std::vector<std::uint32_t> myFacePolys; //per face, the detour poly it came from, numbered within the face's tile
+		std::vector<NavTile> myTiles;
+	};
+
+	//geometry of a single detour tile, welded only within the tile
+	struct NavTileMesh
+	{
+		bool myIsValid = false; //false for unused tile slots
+		int myX = 0;
+		int myY = 0;
+		int myLayer = 0;
+		std::uint64_t myHash = 0; //of the source tile data, see NavTileCache
+		NavMesh myMesh;
+	};
+
+	//accumulates nav geometry in unreal space
+	class NavMeshBuilder
+	{
+	public:
+		explicit NavMeshBuilder(float aWeldEpsilon = 0.0f);
+
+		//returns the index of a welded vertex if one was already added
+		int AddVertex(const Vec3& aVertex);
+		//faces added from now on are tagged with aPoly
+		void SetSourcePoly(std::uint32_t aPoly) { mySourcePoly = aPoly; }
+		void AddTriangle(int aA, int aB, int aC);
+		//triangulates a convex nav poly outline and adds it
+		void AddPolygon(const std::vector<Vec3>& someVertices);
+
+		const NavMesh& GetMesh() const { return myMesh; }
+		NavMesh TakeMesh() { return std::move(myMesh); }
+
+	private:
+		NavMesh myMesh;
+		VertexWelder myWelder;
+		std::uint32_t mySourcePoly = 0;
+	};
+
+	//welds independently built tile meshes together in tile order.
+	//tiles should be built with exact welding, the result is then identical to adding every tile to one builder serially
+	NavMesh MergeTileMeshes(const std::vector<NavTileMesh>& someTiles, float aWeldEpsilon);
+}
@@ -0,0 +1,384 @@
+#include "NavSimplify.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace metronome
+{
+	namespace
+	{
+		struct IndexedPolygon
+		{
+			std::vector<int> myVertices;
+			std::uint32_t myPoly;
+			std::uint32_t myMergeKey;
+			bool myIsAlive = true;
+		};
+
+		std::uint64_t MakeEdgeKey(int aA, int aB)
+		{
+			const std::uint32_t low = static_cast<std::uint32_t>(std::min(aA, aB));
+			const std::uint32_t high = static_cast<std::uint32_t>(std::max(aA, aB));
+			return static_cast<std::uint64_t>(low) << 32 | high;
+		}
+
+		float Cross2D(const Vec3& aOrigin, const Vec3& aA, const Vec3& aB)
+		{
+			return (aA.x - aOrigin.x) * (aB.y - aOrigin.y) - (aA.y - aOrigin.y) * (aB.x - aOrigin.x);
+		}
+
+		float GetSignedArea(const std::vector<Vec3>& someVertices, const std::vector<int>& somePolygon)
+		{
+			float area = 0.0f;
+			for (size_t i = 0; i < somePolygon.size(); ++i)
+			{
+				const Vec3& a = someVertices[somePolygon[i]];
+				const Vec3& b = someVertices[somePolygon[(i + 1) % somePolygon.size()]];
+				area += a.x * b.y - b.x * a.y;
+			}
+			return area * 0.5f;
+		}
+
+		//convex in x/y with the given winding, collinear corners are allowed
+		bool IsConvex(const std::vector<Vec3>& someVertices, const std::vector<int>& somePolygon, float aWinding)
+		{
+			for (size_t i = 0; i < somePolygon.size(); ++i)
+			{
+				const Vec3& a = someVertices[somePolygon[i]];
+				const Vec3& b = someVertices[somePolygon[(i + 1) % somePolygon.size()]];
+				const Vec3& c = someVertices[somePolygon[(i + 2) % somePolygon.size()]];
+				if (Cross2D(a, b, c) * aWinding < -1e-3f)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		//height of the plane through the polygon (newell normal) at aPoint's x/y
+		bool IsWithinPlane(const std::vector<Vec3>& someVertices, const std::vector<int>& somePlanePolygon, const std::vector<int>& someTestPolygon, float aTolerance)
+		{
+			Vec3 normal = { 0.0f, 0.0f, 0.0f };
+			Vec3 centroid = { 0.0f, 0.0f, 0.0f };
+			for (size_t i = 0; i < somePlanePolygon.size(); ++i)
+			{
+				const Vec3& a = someVertices[somePlanePolygon[i]];
+				const Vec3& b = someVertices[somePlanePolygon[(i + 1) % somePlanePolygon.size()]];
+				normal.x += (a.y - b.y) * (a.z + b.z);
+				normal.y += (a.z - b.z) * (a.x + b.x);
+				normal.z += (a.x - b.x) * (a.y + b.y);
+				centroid.x += a.x;
+				centroid.y += a.y;
+				centroid.z += a.z;
+			}
+			if (std::abs(normal.z) < 1e-6f)
+			{
+				return false;
+			}
+			const float count = static_cast<float>(somePlanePolygon.size());
+			centroid = { centroid.x / count, centroid.y / count, centroid.z / count };
+
+			for (int index : someTestPolygon)
+			{
+				const Vec3& point = someVertices[index];
+				const float planeHeight = centroid.z - (normal.x * (point.x - centroid.x) + normal.y * (point.y - centroid.y)) / normal.z;
+				if (std::abs(point.z - planeHeight) > aTolerance)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		//the polys that share an edge with each other, counted as groups
+		int CountEdgeConnectedGroups(const std::vector<IndexedPolygon>& somePolygons)
+		{
+			std::vector<int> parents(somePolygons.size());
+			std::iota(parents.begin(), parents.end(), 0);
+			auto findRoot = [&](int aIndex) {
+				while (parents[aIndex] != aIndex)
+				{
+					parents[aIndex] = parents[parents[aIndex]];
+					aIndex = parents[aIndex];
+				}
+				return aIndex;
+			};
+
+			std::unordered_map<std::uint64_t, int> edgeOwners;
+			int groupCount = 0;
+			for (size_t i = 0; i < somePolygons.size(); ++i)
+			{
+				const IndexedPolygon& polygon = somePolygons[i];
+				if (!polygon.myIsAlive)
+				{
+					continue;
+				}
+				++groupCount;
+				for (size_t j = 0; j < polygon.myVertices.size(); ++j)
+				{
+					const std::uint64_t key = MakeEdgeKey(polygon.myVertices[j], polygon.myVertices[(j + 1) % polygon.myVertices.size()]);
+					const auto inserted = edgeOwners.emplace(key, static_cast<int>(i));
+					if (!inserted.second)
+					{
+						const int a = findRoot(static_cast<int>(i));
+						const int b = findRoot(inserted.first->second);
+						if (a != b)
+						{
+							parents[a] = b;
+							--groupCount;
+						}
+					}
+				}
+			}
+			return groupCount;
+		}
+
+		//finds where aPolygon's vertices in someShared start a single run, false if they don't form exactly one
+		bool FindSharedRun(const std::vector<int>& aPolygon, const std::vector<bool>& someIsShared, size_t& aRunStartOut, size_t& aRunLengthOut)
+		{
+			int runCount = 0;
+			size_t sharedCount = 0;
+			for (size_t i = 0; i < aPolygon.size(); ++i)
+			{
+				sharedCount += someIsShared[i] ? 1 : 0;
+				if (someIsShared[i] && !someIsShared[(i + aPolygon.size() - 1) % aPolygon.size()])
+				{
+					aRunStartOut = i;
+					++runCount;
+				}
+			}
+			aRunLengthOut = sharedCount;
+			return runCount == 1 && sharedCount >= 2;
+		}
+
+		//joins two polys with opposite winding along their shared run:
+		//a from the run's last vertex round to its first, then b's vertices off the run
+		bool MergeAlongSharedRun(const std::vector<int>& aA, const std::vector<int>& aB, const std::vector<int>& someUseCounts, std::vector<int>& aMergedOut)
+		{
+			std::vector<bool> isSharedA(aA.size());
+			std::vector<bool> isSharedB(aB.size());
+			for (size_t i = 0; i < aA.size(); ++i)
+			{
+				isSharedA[i] = std::find(aB.begin(), aB.end(), aA[i]) != aB.end();
+			}
+			for (size_t i = 0; i < aB.size(); ++i)
+			{
+				isSharedB[i] = std::find(aA.begin(), aA.end(), aB[i]) != aA.end();
+			}
+
+			size_t runStartA = 0, runLengthA = 0, runStartB = 0, runLengthB = 0;
+			if (!FindSharedRun(aA, isSharedA, runStartA, runLengthA) || !FindSharedRun(aB, isSharedB, runStartB, runLengthB)
+				|| runLengthA != runLengthB || runLengthA == aA.size() || runLengthB == aB.size())
+			{
+				return false;
+			}
+			for (size_t k = 1; k + 1 < runLengthA; ++k)
+			{
+				if (someUseCounts[aA[(runStartA + k) % aA.size()]] != 2)
+				{
+					return false;
+				}
+			}
+
+			aMergedOut.clear();
+			for (size_t k = runLengthA - 1; k <= aA.size(); ++k)
+			{
+				aMergedOut.push_back(aA[(runStartA + k) % aA.size()]);
+			}
+			for (size_t k = runLengthB; k < aB.size(); ++k)
+			{
+				aMergedOut.push_back(aB[(runStartB + k) % aB.size()]);
+			}
+			return aMergedOut.size() >= 3;
+		}
+
+		struct MergeCandidate
+		{
+			float myLength;
+			int myA;
+			int myB;
+		};
+	}
+
+	std::vector<NavPolygon> SimplifyNavPolygons(const std::vector<NavPolygon>& somePolygons, float aTolerance)
+	{
+		//polys within a tile share exact vertex positions
+		std::vector<Vec3> vertices;
+		VertexWelder welder;
+		std::vector<IndexedPolygon> polygons;
+		Vec3 boundsMin = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0.0f };
+		Vec3 boundsMax = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), 0.0f };
+		for (const NavPolygon& polygon : somePolygons)
+		{
+			IndexedPolygon indexed;
+			indexed.myPoly = polygon.myPoly;
+			indexed.myMergeKey = polygon.myMergeKey;
+			for (const Vec3& vertex : polygon.myVertices)
+			{
+				const int index = welder.FindOrInsert(vertex, static_cast<int>(vertices.size()));
+				if (index == static_cast<int>(vertices.size()))
+				{
+					vertices.push_back(vertex);
+				}
+				indexed.myVertices.push_back(index);
+				boundsMin = { std::min(boundsMin.x, vertex.x), std::min(boundsMin.y, vertex.y), 0.0f };
+				boundsMax = { std::max(boundsMax.x, vertex.x), std::max(boundsMax.y, vertex.y), 0.0f };
+			}
+			polygons.push_back(indexed);
+		}
+		if (polygons.size() < 2)
+		{
+			return somePolygons;
+		}
+
+		const float winding = GetSignedArea(vertices, polygons[0].myVertices) >= 0.0f ? 1.0f : -1.0f;
+		const int originalGroupCount = CountEdgeConnectedGroups(polygons);
+
+		//passes of greedy merges, longest shared edge first, every poly merges at most once per pass
+		bool hasMerged = true;
+		while (hasMerged)
+		{
+			hasMerged = false;
+			std::unordered_map<std::uint64_t, std::vector<int>> edgePolygons;
+			for (size_t i = 0; i < polygons.size(); ++i)
+			{
+				const std::vector<int>& polygon = polygons[i].myVertices;
+				for (size_t j = 0; polygons[i].myIsAlive && j < polygon.size(); ++j)
+				{
+					edgePolygons[MakeEdgeKey(polygon[j], polygon[(j + 1) % polygon.size()])].push_back(static_cast<int>(i));
+				}
+			}
+
+			std::vector<int> useCounts(vertices.size(), 0);
+			for (const IndexedPolygon& polygon : polygons)
+			{
+				for (int vertex : polygon.myVertices)
+				{
+					++useCounts[vertex];
+				}
+			}
+
+			std::vector<MergeCandidate> candidates;
+			for (size_t i = 0; i < polygons.size(); ++i)
+			{
+				const IndexedPolygon& polygon = polygons[i];
+				for (size_t j = 0; polygon.myIsAlive && j < polygon.myVertices.size(); ++j)
+				{
+					const int start = polygon.myVertices[j];
+					const int end = polygon.myVertices[(j + 1) % polygon.myVertices.size()];
+					const std::vector<int>& owners = edgePolygons[MakeEdgeKey(start, end)];
+					if (owners.size() != 2 || owners[0] != static_cast<int>(i))
+					{
+						continue;
+					}
+					const int other = owners[1];
+					if (polygons[other].myMergeKey != polygon.myMergeKey)
+					{
+						continue;
+					}
+					const float dx = vertices[end].x - vertices[start].x;
+					const float dy = vertices[end].y - vertices[start].y;
+					candidates.push_back({ dx * dx + dy * dy, static_cast<int>(i), other });
+				}
+			}
+			std::stable_sort(candidates.begin(), candidates.end(), [](const MergeCandidate& aA, const MergeCandidate& aB) {
+				return aA.myLength > aB.myLength;
+			});
+
+			std::vector<bool> isTouched(polygons.size(), false);
+			for (const MergeCandidate& candidate : candidates)
+			{
+				if (isTouched[candidate.myA] || isTouched[candidate.myB])
+				{
+					continue;
+				}
+				const std::vector<int>& a = polygons[candidate.myA].myVertices;
+				const std::vector<int>& b = polygons[candidate.myB].myVertices;
+
+				//the shared boundary has to be one run of vertices, its inner vertices disappear and must not be used by a third poly
+				std::vector<int> merged;
+				if (!MergeAlongSharedRun(a, b, useCounts, merged))
+				{
+					continue;
+				}
+
+				if (!IsConvex(vertices, merged, winding)
+					|| !IsWithinPlane(vertices, a, b, aTolerance)
+					|| !IsWithinPlane(vertices, b, a, aTolerance))
+				{
+					continue;
+				}
+
+				polygons[candidate.myA].myVertices = merged;
+				polygons[candidate.myA].myPoly = std::min(polygons[candidate.myA].myPoly, polygons[candidate.myB].myPoly);
+				polygons[candidate.myB].myIsAlive = false;
+				polygons[candidate.myB].myVertices.clear();
+				isTouched[candidate.myA] = true;
+				isTouched[candidate.myB] = true;
+				hasMerged = true;
+			}
+		}
+
+		//drop collinear vertices nothing else uses, away from the tile bounds where neighbour tiles attach
+		std::vector<int> useCounts(vertices.size(), 0);
+		for (const IndexedPolygon& polygon : polygons)
+		{
+			for (int vertex : polygon.myVertices)
+			{
+				++useCounts[vertex];
+			}
+		}
+		for (IndexedPolygon& polygon : polygons)
+		{
+			std::vector<int>& indices = polygon.myVertices;
+			for (size_t j = 0; indices.size() > 3 && j < indices.size();)
+			{
+				const Vec3& previous = vertices[indices[(j + indices.size() - 1) % indices.size()]];
+				const Vec3& current = vertices[indices[j]];
+				const Vec3& next = vertices[indices[(j + 1) % indices.size()]];
+				const bool isOnBounds = current.x == boundsMin.x || current.x == boundsMax.x || current.y == boundsMin.y || current.y == boundsMax.y;
+
+				const Vec3 line = { next.x - previous.x, next.y - previous.y, next.z - previous.z };
+				const Vec3 offset = { current.x - previous.x, current.y - previous.y, current.z - previous.z };
+				const float lineLengthSquared = line.x * line.x + line.y * line.y + line.z * line.z;
+				const Vec3 cross = { line.y * offset.z - line.z * offset.y, line.z * offset.x - line.x * offset.z, line.x * offset.y - line.y * offset.x };
+				const float distanceSquared = lineLengthSquared > 0.0f ? (cross.x * cross.x + cross.y * cross.y + cross.z * cross.z) / lineLengthSquared : 0.0f;
+
+				if (useCounts[indices[j]] == 1 && !isOnBounds && distanceSquared <= aTolerance * aTolerance)
+				{
+					indices.erase(indices.begin() + j);
+				}
+				else
+				{
+					++j;
+				}
+			}
+		}
+
+		if (CountEdgeConnectedGroups(polygons) != originalGroupCount)
+		{
+			return somePolygons;
+		}
+
+		std::vector<NavPolygon> result;
+		for (const IndexedPolygon& polygon : polygons)
+		{
+			if (!polygon.myIsAlive)
+			{
+				continue;
+			}
+			NavPolygon simplified;
+			simplified.myPoly = polygon.myPoly;
+			simplified.myMergeKey = polygon.myMergeKey;
+			for (int index : polygon.myVertices)
+			{
+				simplified.myVertices.push_back(vertices[index]);
+			}
+			result.push_back(std::move(simplified));
+		}
+		return result;
+	}
+}
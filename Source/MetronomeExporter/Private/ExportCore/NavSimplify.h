@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ExportMath.h"
+#include <cstdint>
+#include <vector>
+
+//export time simplification of one tile's nav polys.
+//adjacent polys with the same area and flags whose vertices lie within a height tolerance of each other's plane are
+//merged while the result stays convex, then vertices only the merged poly uses are dropped where they are collinear.
+//vertices on the tile's bounds are always kept so the tile still welds to its neighbours.
+//this only reduces geometry. the graph sections are still gathered per detour poly, so a merged poly's triangles
+//point at one detour poly of the merged region while the centroids and portals describe the unmerged polys
+namespace metronome
+{
+	struct NavPolygon
+	{
+		std::vector<Vec3> myVertices; //unreal space, convex in x/y
+		std::uint32_t myPoly = 0; //detour poly, for merged polys the lowest of them (same area and flags as the rest)
+		std::uint32_t myMergeKey = 0; //only polys with the same key merge, e.g. area and flags
+	};
+
+	//returns the polys unchanged if the result would connect them differently
+	std::vector<NavPolygon> SimplifyNavPolygons(const std::vector<NavPolygon>& somePolygons, float aTolerance);
+}
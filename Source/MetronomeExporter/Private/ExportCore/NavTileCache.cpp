@@ -0,0 +1,122 @@
+#include "NavTileCache.h"
+#include <fstream>
+#include <iterator>
+
+namespace metronome
+{
+	static_assert(sizeof(Vec3) == 12 && sizeof(Face) == 12, "cache sections store Vec3 and Face as is");
+
+	template <typename T>
+	static const T* FindItems(const NavBinaryView& aView, std::uint32_t anId, size_t& aCountOut)
+	{
+		size_t size = 0;
+		const void* data = aView.FindSection(anId, &size);
+		aCountOut = size / sizeof(T);
+		return data != nullptr && size % sizeof(T) == 0 ? static_cast<const T*>(data) : nullptr;
+	}
+
+	bool NavTileCache::Load(const std::string& aPath)
+	{
+		myTiles.clear();
+
+		std::ifstream file(aPath, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		const std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		NavBinaryView view;
+		if (!view.Init(data.data(), data.size()))
+		{
+			return false;
+		}
+
+		size_t versionCount = 0;
+		const std::uint32_t* version = FindItems<std::uint32_t>(view, NavCacheSection::version, versionCount);
+		if (version == nullptr || versionCount != 1 || *version != navTileCacheVersion)
+		{
+			return false;
+		}
+
+		size_t recordCount = 0;
+		size_t vertexCount = 0;
+		size_t faceCount = 0;
+		size_t facePolyCount = 0;
+		const NavTileCacheRecord* records = FindItems<NavTileCacheRecord>(view, NavCacheSection::tiles, recordCount);
+		const Vec3* vertices = FindItems<Vec3>(view, NavCacheSection::vertices, vertexCount);
+		const Face* faces = FindItems<Face>(view, NavCacheSection::faces, faceCount);
+		const std::uint32_t* facePolys = FindItems<std::uint32_t>(view, NavCacheSection::facePolys, facePolyCount);
+		if (records == nullptr || vertices == nullptr || faces == nullptr || facePolys == nullptr || facePolyCount != faceCount)
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < recordCount; ++i)
+		{
+			const NavTileCacheRecord& record = records[i];
+			if (static_cast<size_t>(record.myFirstVertex) + record.myVertexCount > vertexCount
+				|| static_cast<size_t>(record.myFirstFace) + record.myFaceCount > faceCount)
+			{
+				myTiles.clear();
+				return false;
+			}
+
+			Entry& entry = myTiles[std::make_tuple(record.myX, record.myY, record.myLayer)];
+			entry.myHash = record.myHash;
+			entry.myMesh.myVertices.assign(vertices + record.myFirstVertex, vertices + record.myFirstVertex + record.myVertexCount);
+			entry.myMesh.myFaces.assign(faces + record.myFirstFace, faces + record.myFirstFace + record.myFaceCount);
+			entry.myMesh.myFacePolys.assign(facePolys + record.myFirstFace, facePolys + record.myFirstFace + record.myFaceCount);
+		}
+		return true;
+	}
+
+	bool NavTileCache::Save(const std::string& aPath, const std::vector<NavTileMesh>& someTiles)
+	{
+		std::vector<NavTileCacheRecord> records;
+		std::vector<Vec3> vertices;
+		std::vector<Face> faces;
+		std::vector<std::uint32_t> facePolys;
+		for (const NavTileMesh& tile : someTiles)
+		{
+			if (!tile.myIsValid)
+			{
+				continue;
+			}
+
+			NavTileCacheRecord record = {};
+			record.myX = tile.myX;
+			record.myY = tile.myY;
+			record.myLayer = tile.myLayer;
+			record.myHash = tile.myHash;
+			record.myFirstVertex = static_cast<std::uint32_t>(vertices.size());
+			record.myVertexCount = static_cast<std::uint32_t>(tile.myMesh.myVertices.size());
+			record.myFirstFace = static_cast<std::uint32_t>(faces.size());
+			record.myFaceCount = static_cast<std::uint32_t>(tile.myMesh.myFaces.size());
+			records.push_back(record);
+			vertices.insert(vertices.end(), tile.myMesh.myVertices.begin(), tile.myMesh.myVertices.end());
+			faces.insert(faces.end(), tile.myMesh.myFaces.begin(), tile.myMesh.myFaces.end());
+			facePolys.insert(facePolys.end(), tile.myMesh.myFacePolys.begin(), tile.myMesh.myFacePolys.end());
+			facePolys.resize(faces.size(), 0);
+		}
+
+		NavBinaryWriter writer;
+		writer.AddSection(NavCacheSection::version, &navTileCacheVersion, sizeof(navTileCacheVersion));
+		writer.AddSection(NavCacheSection::tiles, records);
+		writer.AddSection(NavCacheSection::vertices, vertices);
+		writer.AddSection(NavCacheSection::faces, faces);
+		writer.AddSection(NavCacheSection::facePolys, facePolys);
+		return writer.Write(aPath);
+	}
+
+	bool NavTileCache::TakeMesh(int aX, int aY, int aLayer, std::uint64_t aHash, NavMesh& aMeshOut)
+	{
+		const auto it = myTiles.find(std::make_tuple(aX, aY, aLayer));
+		if (it == myTiles.end() || it->second.myHash != aHash)
+		{
+			return false;
+		}
+		aMeshOut = std::move(it->second.myMesh);
+		return true;
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "NavBinary.h"
+#include "NavMesh.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+//per tile nav output from the previous export, so unchanged tiles don't have to be triangulated again.
+//stored as a nav binary (see NavBinary.h) with the sections below
+namespace metronome
+{
+	constexpr std::uint32_t navTileCacheVersion = 2; //bump when the tile output changes for the same input
+
+	namespace NavCacheSection
+	{
+		constexpr std::uint32_t version = MakeFourCC('C', 'V', 'E', 'R'); //one uint32, navTileCacheVersion
+		constexpr std::uint32_t tiles = MakeFourCC('C', 'T', 'I', 'L'); //NavTileCacheRecord[]
+		constexpr std::uint32_t vertices = MakeFourCC('C', 'V', 'R', 'T'); //Vec3 per vertex, unreal space
+		constexpr std::uint32_t faces = MakeFourCC('C', 'F', 'A', 'C'); //Face per triangle, one based within the tile
+		constexpr std::uint32_t facePolys = MakeFourCC('C', 'F', 'P', 'L'); //uint32 source poly per triangle
+	}
+
+	struct NavTileCacheRecord
+	{
+		std::int32_t myX;
+		std::int32_t myY;
+		std::int32_t myLayer;
+		std::uint32_t myReserved;
+		std::uint64_t myHash;
+		std::uint32_t myFirstVertex;
+		std::uint32_t myVertexCount;
+		std::uint32_t myFirstFace;
+		std::uint32_t myFaceCount;
+	};
+	static_assert(sizeof(NavTileCacheRecord) == 40, "NavTileCacheRecord layout changed");
+
+	class NavTileCache
+	{
+	public:
+		//a missing or invalid file just leaves the cache empty
+		bool Load(const std::string& aPath);
+		//writes every valid tile, tiles that are gone from the nav mesh drop out of the cache
+		static bool Save(const std::string& aPath, const std::vector<NavTileMesh>& someTiles);
+
+		//moves the cached mesh out if the tile's hash still matches.
+		//different tiles may be taken concurrently, the same tile only once
+		bool TakeMesh(int aX, int aY, int aLayer, std::uint64_t aHash, NavMesh& aMeshOut);
+
+		size_t GetTileCount() const { return myTiles.size(); }
+
+	private:
+		struct Entry
+		{
+			std::uint64_t myHash = 0;
+			NavMesh myMesh;
+		};
+
+		std::map<std::tuple<int, int, int>, Entry> myTiles;
+	};
+}
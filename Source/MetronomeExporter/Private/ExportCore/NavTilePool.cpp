@@ -0,0 +1,22 @@
+#include "NavTilePool.h"
+
+namespace metronome
+{
+	bool NavTilePool::FindMesh(std::uint64_t aHash, NavMesh& aMeshOut) const
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		const auto it = myMeshes.find(aHash);
+		if (it == myMeshes.end())
+		{
+			return false;
+		}
+		aMeshOut = it->second;
+		return true;
+	}
+
+	void NavTilePool::AddMesh(std::uint64_t aHash, const NavMesh& aMesh)
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myMeshes.emplace(aHash, aMesh);
+	}
+}
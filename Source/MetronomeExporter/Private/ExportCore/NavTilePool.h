@@ -0,0 +1,24 @@
+#pragma once
+
+#include "NavMesh.h"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace metronome
+{
+	//tile meshes shared between nav data instances exported side by side, agents whose tiles came out identical
+	//(same tile hash, see NavTileCache) only triangulate them once. safe to use from several threads
+	class NavTilePool
+	{
+	public:
+		//copies the mesh out if another export already built a tile with aHash
+		bool FindMesh(std::uint64_t aHash, NavMesh& aMeshOut) const;
+		//the first mesh added for a hash is kept
+		void AddMesh(std::uint64_t aHash, const NavMesh& aMesh);
+
+	private:
+		mutable std::mutex myMutex;
+		std::unordered_map<std::uint64_t, NavMesh> myMeshes;
+	};
+}
@@ -0,0 +1,37 @@
+#include "NavTileSet.h"
+#include <fstream>
+
+namespace metronome
+{
+	static void WritePadding(std::ofstream& aFile, size_t aSize)
+	{
+		static const char zeros[navTileSetAlignment] = {};
+		aFile.write(zeros, static_cast<std::streamsize>(AlignNavTileSetSize(aSize) - aSize));
+	}
+
+	bool WriteNavTileSet(const std::string& aPath, const void* someParams, size_t aParamsSize, const std::vector<NavTileBlob>& someTiles)
+	{
+		std::ofstream file(aPath, std::ios::binary);
+
+		NavTileSetHeader header;
+		header.myMagic = navTileSetMagic;
+		header.myVersion = navTileSetVersion;
+		header.myTileCount = static_cast<std::uint32_t>(someTiles.size());
+		header.myParamsSize = static_cast<std::uint32_t>(aParamsSize);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(static_cast<const char*>(someParams), static_cast<std::streamsize>(aParamsSize));
+		WritePadding(file, aParamsSize);
+
+		for (const NavTileBlob& blob : someTiles)
+		{
+			NavTileSetTile tile;
+			tile.myTileRef = blob.myTileRef;
+			tile.mySize = static_cast<std::uint32_t>(blob.mySize);
+			tile.myReserved = 0;
+			file.write(reinterpret_cast<const char*>(&tile), sizeof(tile));
+			file.write(reinterpret_cast<const char*>(blob.myData), static_cast<std::streamsize>(blob.mySize));
+			WritePadding(file, blob.mySize);
+		}
+		return static_cast<bool>(file);
+	}
+}
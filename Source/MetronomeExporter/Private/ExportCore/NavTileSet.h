@@ -0,0 +1,54 @@
+#pragma once
+
+#include "NavBinary.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//raw detour tiles, so a runtime built against the same detour version can init a dtNavMesh from the params and
+//addTile every blob as is. not detour's MSET sample format, that one has no params size and no tile padding.
+//
+//file layout (native endianness, blobs are never converted):
+//	NavTileSetHeader
+//	params blob (dtNavMeshParams), padded to 8 bytes
+//	per tile: NavTileSetTile followed by mySize bytes of dtMeshTile::data, padded to 8 bytes
+//
+//everything starts 8 byte aligned, a runtime can map the file and read tiles in place even with 64 bit poly refs
+namespace metronome
+{
+	constexpr std::uint32_t navTileSetMagic = MakeFourCC('M', 'N', 'T', 'S');
+	constexpr std::uint32_t navTileSetVersion = 1;
+	constexpr size_t navTileSetAlignment = 8;
+
+	struct NavTileSetHeader
+	{
+		std::uint32_t myMagic;
+		std::uint32_t myVersion;
+		std::uint32_t myTileCount;
+		std::uint32_t myParamsSize; //without the padding
+	};
+	static_assert(sizeof(NavTileSetHeader) == 16, "NavTileSetHeader layout changed");
+
+	struct NavTileSetTile
+	{
+		std::uint64_t myTileRef; //pass to addTile as lastRef so refs stay valid between export and runtime
+		std::uint32_t mySize; //without the padding
+		std::uint32_t myReserved;
+	};
+	static_assert(sizeof(NavTileSetTile) == 16, "NavTileSetTile layout changed");
+
+	struct NavTileBlob
+	{
+		std::uint64_t myTileRef = 0;
+		const unsigned char* myData = nullptr;
+		size_t mySize = 0;
+	};
+
+	constexpr size_t AlignNavTileSetSize(size_t aSize)
+	{
+		return (aSize + navTileSetAlignment - 1) / navTileSetAlignment * navTileSetAlignment;
+	}
+
+	bool WriteNavTileSet(const std::string& aPath, const void* someParams, size_t aParamsSize, const std::vector<NavTileBlob>& someTiles);
+}
@@ -0,0 +1,149 @@
+#include "ObjWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <vector>
+
+namespace metronome
+{
+	//shortest round trip text is at most "-1.17549435e-38", fixed text at most the 39 integer digits of FLT_MAX,
+	//a sign, a point and the precision
+	constexpr size_t maxShortestFloatLength = 16;
+	constexpr size_t maxFixedIntegerLength = 41;
+	constexpr size_t flushSize = 1 << 20;
+
+	//longest line is "f " + 3 * (10 digits + separator) or "v " + 3 * (longest float + separator)
+	static size_t GetMaxLineLength(int aPrecision)
+	{
+		const size_t floatLength = aPrecision < 0 ? maxShortestFloatLength : maxFixedIntegerLength + aPrecision;
+		return 2 + 3 * (std::max<size_t>(floatLength, 10) + 1);
+	}
+
+	static bool AppendFloat(char*& anOut, char* anEnd, float aValue, int aPrecision)
+	{
+		const std::to_chars_result result = aPrecision < 0
+			? std::to_chars(anOut, anEnd, aValue)
+			: std::to_chars(anOut, anEnd, aValue, std::chars_format::fixed, aPrecision);
+		anOut = result.ptr;
+		return result.ec == std::errc();
+	}
+
+	static bool AppendUInt(char*& anOut, char* anEnd, std::uint32_t aValue)
+	{
+		const std::to_chars_result result = std::to_chars(anOut, anEnd, aValue);
+		anOut = result.ptr;
+		return result.ec == std::errc();
+	}
+
+	static char* AppendLiteral(char* aOut, const char* aLiteral)
+	{
+		while (*aLiteral != '\0')
+		{
+			*aOut++ = *aLiteral++;
+		}
+		return aOut;
+	}
+
+	//appends lines [aBegin, anEnd) where the vertices come first and the faces after them, false if a number didn't fit
+	static bool FormatLines(std::vector<char>& aBuffer, const NavMesh& aMesh, size_t aBegin, size_t anEnd, int aPrecision)
+	{
+		const size_t vertexCount = aMesh.myVertices.size();
+		const size_t maxLineLength = GetMaxLineLength(aPrecision);
+		for (size_t line = aBegin; line < anEnd; ++line)
+		{
+			const size_t used = aBuffer.size();
+			aBuffer.resize(used + maxLineLength);
+			char* out = aBuffer.data() + used;
+			//room for the separators and the newline
+			char* end = aBuffer.data() + aBuffer.size() - 3;
+
+			bool succeeded;
+			if (line < vertexCount)
+			{
+				const Vec3 vertex = ToExportVector(aMesh.myVertices[line]);
+				out = AppendLiteral(out, "v ");
+				succeeded = AppendFloat(out, end, vertex.x, aPrecision);
+				*out++ = ' ';
+				succeeded = succeeded && AppendFloat(out, end, vertex.y, aPrecision);
+				*out++ = ' ';
+				succeeded = succeeded && AppendFloat(out, end, vertex.z, aPrecision);
+			}
+			else
+			{
+				const Face& face = aMesh.myFaces[line - vertexCount];
+				out = AppendLiteral(out, "f ");
+				succeeded = AppendUInt(out, end, face.x);
+				*out++ = ' ';
+				succeeded = succeeded && AppendUInt(out, end, face.y);
+				*out++ = ' ';
+				succeeded = succeeded && AppendUInt(out, end, face.z);
+			}
+			if (!succeeded)
+			{
+				aBuffer.resize(used);
+				return false;
+			}
+			*out++ = '\n';
+			aBuffer.resize(out - aBuffer.data());
+		}
+		return true;
+	}
+
+	static bool WriteBuffer(std::FILE* aFile, std::vector<char>& aBuffer)
+	{
+		const bool succeeded = std::fwrite(aBuffer.data(), 1, aBuffer.size(), aFile) == aBuffer.size();
+		aBuffer.clear();
+		return succeeded;
+	}
+
+	bool WriteObj(const std::string& aPath, const NavMesh& aMesh, const ObjWriteSettings& aSettings, const ParallelForFn& aParallelFor)
+	{
+		//text mode like the std::ofstream this replaced, so line endings stay the same on windows
+		std::FILE* file = std::fopen(aPath.c_str(), "w");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		bool succeeded = true;
+		const int precision = aSettings.myPrecision < 0 ? -1 : std::min(aSettings.myPrecision, maxObjPrecision);
+		const size_t lineCount = aMesh.myVertices.size() + aMesh.myFaces.size();
+		const size_t linesPerChunk = static_cast<size_t>(std::max(aSettings.myLinesPerChunk, 1));
+		if (aParallelFor)
+		{
+			const int chunkCount = static_cast<int>((lineCount + linesPerChunk - 1) / linesPerChunk);
+			std::vector<std::vector<char>> chunks(chunkCount);
+			std::vector<char> chunkSucceeded(chunkCount, 0);
+			aParallelFor(chunkCount, [&](int aChunk) {
+				const size_t begin = aChunk * linesPerChunk;
+				chunks[aChunk].reserve(linesPerChunk * 32);
+				chunkSucceeded[aChunk] = FormatLines(chunks[aChunk], aMesh, begin, std::min(begin + linesPerChunk, lineCount), precision);
+			});
+			for (int i = 0; i < chunkCount && succeeded; ++i)
+			{
+				succeeded &= chunkSucceeded[i] != 0 && WriteBuffer(file, chunks[i]);
+			}
+		}
+		else
+		{
+			std::vector<char> buffer;
+			buffer.reserve(flushSize + linesPerChunk * GetMaxLineLength(precision));
+			for (size_t begin = 0; begin < lineCount && succeeded; begin += linesPerChunk)
+			{
+				succeeded &= FormatLines(buffer, aMesh, begin, std::min(begin + linesPerChunk, lineCount), precision);
+				if (buffer.size() >= flushSize)
+				{
+					succeeded &= WriteBuffer(file, buffer);
+				}
+			}
+			succeeded &= WriteBuffer(file, buffer);
+		}
+
+		const int indiceOffset = 0;
+		const int footerLength = std::fprintf(file, "#VerticesCount: %zu\n#FaceCount: %zu\n#IndicdeOffset: %d\n", aMesh.myVertices.size(), aMesh.myFaces.size(), indiceOffset);
+		succeeded &= footerLength > 0;
+
+		succeeded &= std::fclose(file) == 0;
+		return succeeded;
+	}
+}
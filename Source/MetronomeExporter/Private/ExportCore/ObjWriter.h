@@ -0,0 +1,20 @@
+#pragma once
+
+#include "NavMesh.h"
+#include "Parallel.h"
+#include <string>
+
+namespace metronome
+{
+	constexpr int maxObjPrecision = 9; //enough to round trip any float in fixed notation
+
+	struct ObjWriteSettings
+	{
+		int myPrecision = -1; //digits after the decimal point clamped to maxObjPrecision, -1 writes the shortest text that round trips
+		int myLinesPerChunk = 16384; //unit of work when formatting in parallel
+	};
+
+	//formats into large buffers with std::to_chars and writes them in big blocks, chunks are formatted
+	//concurrently when aParallelFor is given and always written in order
+	bool WriteObj(const std::string& aPath, const NavMesh& aMesh, const ObjWriteSettings& aSettings = {}, const ParallelForFn& aParallelFor = {});
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <functional>
+
+namespace metronome
+{
+	//runs aBody(i) for every i in [0, aCount), possibly concurrently. lets the core run on the engine's task graph
+	using ParallelForFn = std::function<void(int aCount, const std::function<void(int)>& aBody)>;
+
+	//falls back to a plain loop when no aParallelFor is given
+	inline void RunParallelFor(const ParallelForFn& aParallelFor, int aCount, const std::function<void(int)>& aBody)
+	{
+		if (aParallelFor)
+		{
+			aParallelFor(aCount, aBody);
+			return;
+		}
+		for (int i = 0; i < aCount; ++i)
+		{
+			aBody(i);
+		}
+	}
+}
@@ -0,0 +1,168 @@
+#include "SceneBinary.h"
+#include <unordered_map>
+
+namespace metronome
+{
+	//deduplicates strings, asset paths repeat a lot
+	class StringPool
+	{
+	public:
+		StringPool() { myData.push_back('\0'); }
+
+		std::uint32_t Add(const std::string& aString)
+		{
+			if (aString.empty())
+			{
+				return 0;
+			}
+			const auto it = myOffsets.find(aString);
+			if (it != myOffsets.end())
+			{
+				return it->second;
+			}
+			const std::uint32_t offset = static_cast<std::uint32_t>(myData.size());
+			myData.insert(myData.end(), aString.begin(), aString.end());
+			myData.push_back('\0');
+			myOffsets.emplace(aString, offset);
+			return offset;
+		}
+
+		const std::vector<char>& GetData() const { return myData; }
+
+	private:
+		std::vector<char> myData;
+		std::unordered_map<std::string, std::uint32_t> myOffsets;
+	};
+
+	static void CopyVector(const Vec3& aSrc, float* aDst)
+	{
+		aDst[0] = aSrc.x;
+		aDst[1] = aSrc.y;
+		aDst[2] = aSrc.z;
+	}
+
+	static SceneBinaryLight ToBinaryLight(std::uint32_t anEntity, const Light& aSrc)
+	{
+		SceneBinaryLight light = {};
+		light.myEntity = anEntity;
+		light.myColor[0] = aSrc.myColor.r;
+		light.myColor[1] = aSrc.myColor.g;
+		light.myColor[2] = aSrc.myColor.b;
+		light.myColor[3] = aSrc.myColor.a;
+		light.myIntensity = aSrc.myIntensity;
+		return light;
+	}
+
+	void AddSceneSections(NavBinaryWriter& aWriter, const SceneSnapshot& aSnapshot)
+	{
+		StringPool strings;
+		std::vector<std::uint32_t> childOffsets;
+		std::vector<std::uint32_t> children;
+		GetSceneChildren(aSnapshot, childOffsets, children);
+
+		std::vector<SceneBinaryEntity> entities(aSnapshot.myEntities.size());
+		for (size_t i = 0; i < entities.size(); ++i)
+		{
+			const SceneEntity& src = aSnapshot.myEntities[i];
+			SceneBinaryEntity& entity = entities[i];
+			entity = {};
+			entity.myName = strings.Add(src.myName);
+			entity.myParent = src.myParent >= 0 ? static_cast<std::uint32_t>(src.myParent) : sceneNoEntity;
+			entity.myFirstChild = childOffsets[i];
+			entity.myChildCount = childOffsets[i + 1] - childOffsets[i];
+			entity.myFlags = src.myIsFolder ? SceneEntityFlags::folder : 0;
+			entity.myTransform = sceneNoEntity;
+		}
+
+		std::vector<SceneBinaryTransform> transforms;
+		transforms.reserve(aSnapshot.myTransforms.size());
+		for (const SceneComponent<Transform>& src : aSnapshot.myTransforms)
+		{
+			SceneBinaryTransform transform;
+			transform.myEntity = src.myEntity;
+			CopyVector(ToExportVector(src.myData.myLocation * 0.01f), transform.myPosition);
+			CopyVector(ToExportEuler(src.myData.myRotation), transform.myRotation);
+			CopyVector(Abs(ToExportVector(src.myData.myScale)), transform.myScale);
+			//actors have exactly one
+			entities[src.myEntity].myTransform = static_cast<std::uint32_t>(transforms.size());
+			transforms.push_back(transform);
+		}
+
+		std::vector<SceneBinaryLight> pointLights;
+		for (const SceneComponent<PointLight>& src : aSnapshot.myPointLights)
+		{
+			SceneBinaryLight light = ToBinaryLight(src.myEntity, src.myData);
+			light.myRange = src.myData.myAttenuationRadius * 0.01f;
+			pointLights.push_back(light);
+		}
+		std::vector<SceneBinaryLight> spotLights;
+		for (const SceneComponent<SpotLight>& src : aSnapshot.mySpotLights)
+		{
+			SceneBinaryLight light = ToBinaryLight(src.myEntity, src.myData);
+			light.myRange = src.myData.myAttenuationRadius * 0.01f;
+			light.myInnerConeAngle = src.myData.myInnerConeAngle;
+			light.myOuterConeAngle = src.myData.myOuterConeAngle;
+			spotLights.push_back(light);
+		}
+		std::vector<SceneBinaryLight> directionalLights;
+		for (const SceneComponent<DirectionalLight>& src : aSnapshot.myDirectionalLights)
+		{
+			directionalLights.push_back(ToBinaryLight(src.myEntity, src.myData));
+		}
+
+		std::vector<SceneBinaryMeshRenderer> meshRenderers;
+		std::vector<std::uint32_t> materials;
+		for (const SceneComponent<MeshRenderer>& src : aSnapshot.myMeshRenderers)
+		{
+			SceneBinaryMeshRenderer meshRenderer;
+			meshRenderer.myEntity = src.myEntity;
+			meshRenderer.myModelPath = strings.Add(src.myData.myModelPath);
+			meshRenderer.myFirstMaterial = static_cast<std::uint32_t>(materials.size());
+			meshRenderer.myMaterialCount = static_cast<std::uint32_t>(src.myData.myMaterialPaths.size());
+			for (const std::string& materialPath : src.myData.myMaterialPaths)
+			{
+				materials.push_back(strings.Add(materialPath));
+			}
+			meshRenderers.push_back(meshRenderer);
+		}
+
+		std::vector<SceneBinaryCamera> cameras;
+		for (const SceneComponent<Camera>& src : aSnapshot.myCameras)
+		{
+			cameras.push_back({ src.myEntity, src.myData.myFov, src.myData.myNearPlane, src.myData.myFarPlane });
+		}
+		std::vector<SceneBinaryBoxCollider> boxColliders;
+		for (const SceneComponent<BoxCollider>& src : aSnapshot.myBoxColliders)
+		{
+			SceneBinaryBoxCollider boxCollider;
+			boxCollider.myEntity = src.myEntity;
+			CopyVector(ToExportVector(src.myData.myExtent * 2), boxCollider.mySize);
+			boxColliders.push_back(boxCollider);
+		}
+		std::vector<SceneBinarySphereCollider> sphereColliders;
+		for (const SceneComponent<SphereCollider>& src : aSnapshot.mySphereColliders)
+		{
+			sphereColliders.push_back({ src.myEntity, src.myData.myRadius });
+		}
+
+		aWriter.AddSection(SceneSection::strings, strings.GetData());
+		aWriter.AddSection(SceneSection::entities, entities);
+		aWriter.AddSection(SceneSection::children, children);
+		aWriter.AddSection(SceneSection::transforms, transforms);
+		aWriter.AddSection(SceneSection::pointLights, pointLights);
+		aWriter.AddSection(SceneSection::spotLights, spotLights);
+		aWriter.AddSection(SceneSection::directionalLights, directionalLights);
+		aWriter.AddSection(SceneSection::meshRenderers, meshRenderers);
+		aWriter.AddSection(SceneSection::materials, materials);
+		aWriter.AddSection(SceneSection::cameras, cameras);
+		aWriter.AddSection(SceneSection::boxColliders, boxColliders);
+		aWriter.AddSection(SceneSection::sphereColliders, sphereColliders);
+	}
+
+	bool WriteSceneBinary(const std::string& aPath, const SceneSnapshot& aSnapshot)
+	{
+		NavBinaryWriter writer(sceneBinaryMagic);
+		AddSceneSections(writer, aSnapshot);
+		return writer.Write(aPath);
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "NavBinary.h"
+#include "SceneSnapshot.h"
+#include <cstdint>
+#include <string>
+
+//fixed layout scene tables in the nav binary container, meant to be mapped and read in place.
+//records reference entities by index and strings by byte offset into the string pool, where 0 is the empty string.
+//positions, rotations and sizes are converted like the .fab ones
+namespace metronome
+{
+	constexpr std::uint32_t sceneBinaryMagic = MakeFourCC('M', 'S', 'C', 'N');
+	constexpr std::uint32_t sceneNoEntity = 0xFFFFFFFF;
+
+	namespace SceneSection
+	{
+		constexpr std::uint32_t strings = MakeFourCC('S', 'S', 'T', 'R'); //zero terminated utf-8
+		constexpr std::uint32_t entities = MakeFourCC('S', 'E', 'N', 'T'); //SceneBinaryEntity[] depth first, the first is the root
+		constexpr std::uint32_t children = MakeFourCC('S', 'C', 'H', 'L'); //uint32 entity, grouped by parent in SENT order
+		//component tables, sorted by entity
+		constexpr std::uint32_t transforms = MakeFourCC('S', 'T', 'R', 'N'); //SceneBinaryTransform[]
+		constexpr std::uint32_t pointLights = MakeFourCC('S', 'P', 'N', 'T'); //SceneBinaryLight[]
+		constexpr std::uint32_t spotLights = MakeFourCC('S', 'S', 'P', 'T'); //SceneBinaryLight[]
+		constexpr std::uint32_t directionalLights = MakeFourCC('S', 'D', 'I', 'R'); //SceneBinaryLight[], range and cone angles are 0
+		constexpr std::uint32_t meshRenderers = MakeFourCC('S', 'M', 'S', 'H'); //SceneBinaryMeshRenderer[]
+		constexpr std::uint32_t materials = MakeFourCC('S', 'M', 'A', 'T'); //uint32 string offset per material slot
+		constexpr std::uint32_t cameras = MakeFourCC('S', 'C', 'A', 'M'); //SceneBinaryCamera[]
+		constexpr std::uint32_t boxColliders = MakeFourCC('S', 'B', 'O', 'X'); //SceneBinaryBoxCollider[]
+		constexpr std::uint32_t sphereColliders = MakeFourCC('S', 'S', 'P', 'H'); //SceneBinarySphereCollider[]
+	}
+
+	namespace SceneEntityFlags
+	{
+		constexpr std::uint32_t folder = 1 << 0;
+	}
+
+	struct SceneBinaryEntity
+	{
+		std::uint32_t myName;
+		std::uint32_t myParent; //sceneNoEntity for the root
+		std::uint32_t myFirstChild; //into SCHL
+		std::uint32_t myChildCount;
+		std::uint32_t myFlags;
+		std::uint32_t myTransform; //into STRN, sceneNoEntity for folders
+		std::uint32_t myReserved[2];
+	};
+	static_assert(sizeof(SceneBinaryEntity) == 32, "SceneBinaryEntity layout changed");
+
+	struct SceneBinaryTransform
+	{
+		std::uint32_t myEntity;
+		float myPosition[3];
+		float myRotation[3]; //euler degrees
+		float myScale[3];
+	};
+	static_assert(sizeof(SceneBinaryTransform) == 40, "SceneBinaryTransform layout changed");
+
+	struct SceneBinaryLight
+	{
+		std::uint32_t myEntity;
+		float myColor[4]; //rgba
+		float myIntensity;
+		float myRange;
+		float myInnerConeAngle;
+		float myOuterConeAngle;
+		std::uint32_t myReserved[3];
+	};
+	static_assert(sizeof(SceneBinaryLight) == 48, "SceneBinaryLight layout changed");
+
+	struct SceneBinaryMeshRenderer
+	{
+		std::uint32_t myEntity;
+		std::uint32_t myModelPath;
+		std::uint32_t myFirstMaterial; //into SMAT
+		std::uint32_t myMaterialCount;
+	};
+	static_assert(sizeof(SceneBinaryMeshRenderer) == 16, "SceneBinaryMeshRenderer layout changed");
+
+	struct SceneBinaryCamera
+	{
+		std::uint32_t myEntity;
+		float myFov;
+		float myNearPlane;
+		float myFarPlane;
+	};
+	static_assert(sizeof(SceneBinaryCamera) == 16, "SceneBinaryCamera layout changed");
+
+	struct SceneBinaryBoxCollider
+	{
+		std::uint32_t myEntity;
+		float mySize[3];
+	};
+	static_assert(sizeof(SceneBinaryBoxCollider) == 16, "SceneBinaryBoxCollider layout changed");
+
+	struct SceneBinarySphereCollider
+	{
+		std::uint32_t myEntity;
+		float myRadius;
+	};
+	static_assert(sizeof(SceneBinarySphereCollider) == 8, "SceneBinarySphereCollider layout changed");
+
+	void AddSceneSections(NavBinaryWriter& aWriter, const SceneSnapshot& aSnapshot);
+	bool WriteSceneBinary(const std::string& aPath, const SceneSnapshot& aSnapshot);
+}
@@ -0,0 +1,33 @@
+#include "SceneSnapshot.h"
+
+namespace metronome
+{
+	void GetSceneChildren(const SceneSnapshot& aSnapshot, std::vector<std::uint32_t>& someOffsets, std::vector<std::uint32_t>& someChildren)
+	{
+		const size_t entityCount = aSnapshot.myEntities.size();
+		someOffsets.assign(entityCount + 1, 0);
+		for (const SceneEntity& entity : aSnapshot.myEntities)
+		{
+			if (entity.myParent >= 0)
+			{
+				++someOffsets[entity.myParent + 1];
+			}
+		}
+		for (size_t i = 0; i < entityCount; ++i)
+		{
+			someOffsets[i + 1] += someOffsets[i];
+		}
+
+		//entities are visited in order, so children land in order too
+		someChildren.resize(someOffsets[entityCount]);
+		std::vector<std::uint32_t> fill(someOffsets.begin(), someOffsets.end() - 1);
+		for (size_t i = 0; i < entityCount; ++i)
+		{
+			const std::int32_t parent = aSnapshot.myEntities[i].myParent;
+			if (parent >= 0)
+			{
+				someChildren[fill[parent]++] = static_cast<std::uint32_t>(i);
+			}
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "FabJson.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+//the exportable part of a level, copied out of the engine so it can be written without touching UObjects.
+//everything is in unreal units, the writers convert
+namespace metronome
+{
+	struct SceneEntity
+	{
+		std::string myName;
+		std::int32_t myParent = -1;
+		bool myIsFolder = false;
+	};
+
+	template <typename T>
+	struct SceneComponent
+	{
+		std::uint32_t myEntity;
+		T myData;
+	};
+
+	struct SceneSnapshot
+	{
+		//depth first, so a parent comes before its children and children keep their order
+		std::vector<SceneEntity> myEntities;
+		//component tables are sorted by entity, an entity's components of one type keep their order.
+		//folders only have their name and children
+		std::vector<SceneComponent<Transform>> myTransforms;
+		std::vector<SceneComponent<PointLight>> myPointLights;
+		std::vector<SceneComponent<SpotLight>> mySpotLights;
+		std::vector<SceneComponent<DirectionalLight>> myDirectionalLights;
+		std::vector<SceneComponent<MeshRenderer>> myMeshRenderers;
+		std::vector<SceneComponent<Camera>> myCameras;
+		std::vector<SceneComponent<BoxCollider>> myBoxColliders;
+		std::vector<SceneComponent<SphereCollider>> mySphereColliders;
+	};
+
+	//children of every entity in order, someOffsets gets one entry per entity plus the total
+	void GetSceneChildren(const SceneSnapshot& aSnapshot, std::vector<std::uint32_t>& someOffsets, std::vector<std::uint32_t>& someChildren);
+
+	template <typename T>
+	struct EntityLess
+	{
+		bool operator()(const SceneComponent<T>& aComponent, std::uint32_t anEntity) const { return aComponent.myEntity < anEntity; }
+		bool operator()(std::uint32_t anEntity, const SceneComponent<T>& aComponent) const { return anEntity < aComponent.myEntity; }
+	};
+
+	//[first, last) of anEntity's components in a sorted table
+	template <typename T>
+	std::pair<const SceneComponent<T>*, const SceneComponent<T>*> FindSceneComponents(const std::vector<SceneComponent<T>>& someComponents, std::uint32_t anEntity)
+	{
+		const auto range = std::equal_range(someComponents.begin(), someComponents.end(), anEntity, EntityLess<T>());
+		return { someComponents.data() + (range.first - someComponents.begin()), someComponents.data() + (range.second - someComponents.begin()) };
+	}
+}
@@ -0,0 +1,169 @@
+#include "VertexWelder.h"
+#include <cmath>
+#include <cstring>
+
+namespace metronome
+{
+	VertexWelder::VertexWelder(float aWeldEpsilon)
+		: myWeldEpsilon(aWeldEpsilon)
+		, myInvWeldEpsilon(aWeldEpsilon > 0.0f ? 1.0f / aWeldEpsilon : 0.0f)
+	{
+	}
+
+	int VertexWelder::Find(const Vec3& aVertex) const
+	{
+		if (myCount == 0)
+		{
+			return -1;
+		}
+
+		const Key key = ToKey(aVertex);
+		if (myWeldEpsilon <= 0.0f)
+		{
+			return FindInCell(key, aVertex);
+		}
+
+		//a vertex within epsilon can sit in any neighbouring cell
+		int result = -1;
+		for (std::int64_t z = -1; z <= 1; ++z)
+		{
+			for (std::int64_t y = -1; y <= 1; ++y)
+			{
+				for (std::int64_t x = -1; x <= 1; ++x)
+				{
+					const int index = FindInCell({ key.x + x, key.y + y, key.z + z }, aVertex);
+					if (index != -1 && (result == -1 || index < result))
+					{
+						result = index;
+					}
+				}
+			}
+		}
+		return result;
+	}
+
+	void VertexWelder::Insert(const Vec3& aVertex, int anIndex)
+	{
+		if ((myCount + 1) * 2 > myEntries.size())
+		{
+			Grow();
+		}
+
+		const Key key = ToKey(aVertex);
+		const size_t mask = myEntries.size() - 1;
+		size_t slot = Hash(key) & mask;
+		while (myEntries[slot].myIndex != -1)
+		{
+			slot = (slot + 1) & mask;
+		}
+		myEntries[slot] = { key, aVertex, anIndex };
+		++myCount;
+	}
+
+	int VertexWelder::FindOrInsert(const Vec3& aVertex, int aNewIndex)
+	{
+		const int index = Find(aVertex);
+		if (index != -1)
+		{
+			return index;
+		}
+		Insert(aVertex, aNewIndex);
+		return aNewIndex;
+	}
+
+	void VertexWelder::Reserve(size_t aVertexCount)
+	{
+		while (aVertexCount * 2 > myEntries.size())
+		{
+			Grow();
+		}
+	}
+
+	void VertexWelder::Clear()
+	{
+		myEntries.clear();
+		myCount = 0;
+	}
+
+	VertexWelder::Key VertexWelder::ToKey(const Vec3& aVertex) const
+	{
+		if (myWeldEpsilon > 0.0f)
+		{
+			return {
+				static_cast<std::int64_t>(std::floor(aVertex.x * myInvWeldEpsilon)),
+				static_cast<std::int64_t>(std::floor(aVertex.y * myInvWeldEpsilon)),
+				static_cast<std::int64_t>(std::floor(aVertex.z * myInvWeldEpsilon)) };
+		}
+
+		//+0 and -0 compare equal so they have to share a key
+		auto bits = [](float aValue) {
+			std::uint32_t result;
+			aValue = aValue == 0.0f ? 0.0f : aValue;
+			std::memcpy(&result, &aValue, sizeof(result));
+			return static_cast<std::int64_t>(result);
+		};
+		return { bits(aVertex.x), bits(aVertex.y), bits(aVertex.z) };
+	}
+
+	std::uint64_t VertexWelder::Hash(const Key& aKey)
+	{
+		//splitmix64 finalizer over the combined cell
+		std::uint64_t h = static_cast<std::uint64_t>(aKey.x) * 0x9E3779B97F4A7C15ull;
+		h ^= static_cast<std::uint64_t>(aKey.y) + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2);
+		h ^= static_cast<std::uint64_t>(aKey.z) + 0x85157AF5B7B1F1A3ull + (h << 6) + (h >> 2);
+		h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+		h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+		return h ^ (h >> 31);
+	}
+
+	int VertexWelder::FindInCell(const Key& aKey, const Vec3& aVertex) const
+	{
+		const float epsilonSq = myWeldEpsilon * myWeldEpsilon;
+		const size_t mask = myEntries.size() - 1;
+		int result = -1;
+		for (size_t slot = Hash(aKey) & mask; myEntries[slot].myIndex != -1; slot = (slot + 1) & mask)
+		{
+			const Entry& entry = myEntries[slot];
+			if (!(entry.myKey == aKey))
+			{
+				continue;
+			}
+			if (myWeldEpsilon > 0.0f)
+			{
+				const float dx = entry.myPosition.x - aVertex.x;
+				const float dy = entry.myPosition.y - aVertex.y;
+				const float dz = entry.myPosition.z - aVertex.z;
+				if (dx * dx + dy * dy + dz * dz > epsilonSq)
+				{
+					continue;
+				}
+			}
+			if (result == -1 || entry.myIndex < result)
+			{
+				result = entry.myIndex;
+			}
+		}
+		return result;
+	}
+
+	void VertexWelder::Grow()
+	{
+		std::vector<Entry> old = std::move(myEntries);
+		myEntries.assign(old.empty() ? 64 : old.size() * 2, Entry{});
+		myCount = 0;
+		for (const Entry& entry : old)
+		{
+			if (entry.myIndex != -1)
+			{
+				const size_t mask = myEntries.size() - 1;
+				size_t slot = Hash(entry.myKey) & mask;
+				while (myEntries[slot].myIndex != -1)
+				{
+					slot = (slot + 1) & mask;
+				}
+				myEntries[slot] = entry;
+				++myCount;
+			}
+		}
+	}
+}
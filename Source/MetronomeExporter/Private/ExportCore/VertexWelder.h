@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ExportMath.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace metronome
+{
+	//maps positions to vertex indices in O(1), an open addressing hash over quantized positions
+	class VertexWelder
+	{
+	public:
+		//with an epsilon of 0 only bit identical positions are welded
+		explicit VertexWelder(float aWeldEpsilon = 0.0f);
+
+		//returns the lowest index welded to aVertex, or -1
+		int Find(const Vec3& aVertex) const;
+		void Insert(const Vec3& aVertex, int anIndex);
+		//returns the welded index, registering aVertex under aNewIndex if there was none
+		int FindOrInsert(const Vec3& aVertex, int aNewIndex);
+
+		void Reserve(size_t aVertexCount);
+		void Clear();
+
+		float GetWeldEpsilon() const { return myWeldEpsilon; }
+
+	private:
+		struct Key
+		{
+			std::int64_t x, y, z;
+
+			bool operator==(const Key& aOther) const { return x == aOther.x && y == aOther.y && z == aOther.z; }
+		};
+
+		struct Entry
+		{
+			Key myKey;
+			Vec3 myPosition;
+			int myIndex = -1; //-1 marks an empty slot
+		};
+
+		Key ToKey(const Vec3& aVertex) const;
+		static std::uint64_t Hash(const Key& aKey);
+		int FindInCell(const Key& aKey, const Vec3& aVertex) const;
+		void Grow();
+
+		float myWeldEpsilon;
+		float myInvWeldEpsilon;
+		std::vector<Entry> myEntries;
+		size_t myCount = 0;
+	};
+}
@@ -5,13 +5,42 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "json.hpp"
+#include "ExportCore/FabJson.h"
 #include "Components/DirectionalLightComponent.h"
 #include "Components/PointLightComponent.h"
 #include "Components/SpotLightComponent.h"
+#include "Async/Future.h"
 #include "Export.generated.h"
 
+struct dtMeshTile;
+class dtNavMesh;
+class ARecastNavMesh;
+namespace metronome { struct SceneSnapshot; class NavMeshBuilder; class NavTilePool; struct NavTileGraph; struct NavAreaCost; }
+
 DECLARE_LOG_CATEGORY_EXTERN(LogExporter, Log, All);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FExportProgressSignature, float, progress); //0 to 1, broadcast on the game thread
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FExportCompletedSignature, bool, hasSucceeded);
+
+UENUM()
+enum class ENavExportMode : uint8
+{
+	Polygons, //triangulates every nav poly from its outline
+	DetailMesh, //copies the detail triangles detour already stores per tile (includes height detail)
+};
+
+//mirrors metronome::FabFormat up to Bson
+UENUM()
+enum class ESceneExportFormat : uint8
+{
+	Json, //text .fab, see shouldMakeCompactJson
+	MessagePack, //.fab.msgpack
+	Cbor, //.fab.cbor
+	Ubjson, //.fab.ubj
+	Bson, //.fab.bson
+	Mscn, //.mscn, fixed layout tables for loading in place, see SceneBinary.h
+};
+
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class METRONOMEEXPORTER_API UExport : public UActorComponent
 {
@@ -23,12 +52,32 @@ public:
 
 	UPROPERTY(EditAnywhere) FString sceneExportPath;
 	UPROPERTY(EditAnywhere) FString sceneExportName = "Export";
+	UPROPERTY(EditAnywhere) bool shouldExportAsync = true; //only the snapshot runs on the game thread, files are written in the background
+	UPROPERTY(BlueprintAssignable) FExportProgressSignature onExportProgress;
+	UPROPERTY(BlueprintAssignable) FExportCompletedSignature onExportCompleted;
 	UPROPERTY(EditAnywhere) bool shouldMakeCompactJson = true;
+	UPROPERTY(EditAnywhere) ESceneExportFormat sceneExportFormat = ESceneExportFormat::Json; //the binary formats hold the same document as the json but can't be streamed while writing
 	UPROPERTY(EditAnywhere) bool shouldAutoFixLights = false;
 	UPROPERTY(EditAnywhere) float nearPlane = 0.1f;
 	UPROPERTY(EditAnywhere) float farPlane = 100000.0f;
 	UPROPERTY(EditAnywhere) FString modelFallbackPath = "???";
 	UPROPERTY(EditAnywhere) FString materialFallbackPath = "???";
+	UPROPERTY(EditAnywhere) ENavExportMode navExportMode = ENavExportMode::Polygons;
+	UPROPERTY(EditAnywhere) bool shouldExportAllNavData = true; //also exports every other agent's nav mesh to <name>Nav_<agent>
+	UPROPERTY(EditAnywhere) float navSimplifyTolerance = 0.0f; //Polygons mode merges adjacent polys within this height of a shared plane and drops collinear vertices, 0 disables. only shrinks the triangles, the mnav graph, islands, hierarchy and landmarks stay per detour poly
+	UPROPERTY(EditAnywhere) float navWeldEpsilon = 0.0f; //nav vertices closer than this are merged, 0 only merges identical ones
+	UPROPERTY(EditAnywhere) bool shouldUseNavTileCache = true; //keeps <name>Nav.tilecache next to the export and only triangulates tiles that changed
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "-1", ClampMax = "9")) int32 navObjPrecision = -1; //digits after the decimal point in the nav obj, -1 writes the shortest exact text
+	UPROPERTY(EditAnywhere) bool shouldExportNavBinary = true; //writes <name>Nav.mnav next to the obj
+	UPROPERTY(EditAnywhere) bool shouldCompressNavBinary = false; //16 bit positions inside tile bounds and varint indices in every mnav
+	UPROPERTY(EditAnywhere) bool shouldExportNavBvh = true; //adds a bvh over the nav triangles to the mnav for point location queries
+	UPROPERTY(EditAnywhere) bool shouldExportNavGraph = true; //adds poly adjacency, portals and centroids to the mnav
+	UPROPERTY(EditAnywhere) bool shouldExportNavAreas = true; //adds area ids, poly flags, the default filter's area costs and off-mesh links to the mnav, needs shouldExportNavGraph
+	UPROPERTY(EditAnywhere) bool shouldExportNavIslands = true; //adds reachability labels per poly and triangle to the mnav, needs shouldExportNavGraph
+	UPROPERTY(EditAnywhere) bool shouldExportNavHierarchy = true; //adds the tile entrance graph for hierarchical path finding to the mnav, needs shouldExportNavGraph
+	UPROPERTY(EditAnywhere) int32 navLandmarkCount = 8; //landmarks in the mnav's ALT heuristic tables, 2 bytes per poly and landmark each way, needs shouldExportNavGraph, 0 disables
+	UPROPERTY(EditAnywhere) int32 navChunkTiles = 0; //also writes the nav mesh in chunks of NxN tiles with a <name>Nav.chunks.json manifest for streaming, 0 disables
+	UPROPERTY(EditAnywhere) bool shouldExportNavTiles = false; //writes the raw detour tiles to <name>Nav.navtiles for runtimes that addTile them directly
 
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -36,6 +85,7 @@ public:
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 	struct ExportContext
@@ -46,15 +96,31 @@ private:
 		std::map<std::string, Folder> mySubFolders;
 		TArray<AActor*> myActors;
 	};
-
-	void ExportNavMesh(const std::string& aOutPath);
-	int FindIndex(const FVector& aKey, const TArray<FVector>& someVertices);
-
-	void ExportScene(const std::string& aOutPath);
-	nlohmann::json CreateEntity(const AActor& aActor);
-	nlohmann::json CreateFolderEntity(const std::string& aName, const Folder& aFolder);
-	nlohmann::json CreateComponents(const AActor& aActor);
-	static nlohmann::json CreateComponentJson(const std::string& aType, const nlohmann::json& aParams);
+	struct NavDataSnapshot;
+	struct ExportSnapshot;
+
+	//game thread, copies everything the export needs out of the world
+	void SnapshotExport(ExportSnapshot& aSnapshot);
+	//any thread, only reads the snapshot and the export settings
+	void WriteExport(const ExportSnapshot& aSnapshot);
+	void ReportProgress(float aProgress);
+	void ReportCompletion(bool aHasSucceeded);
+
+	void SnapshotNavMesh(const std::string& aOutPathNoExt, std::vector<NavDataSnapshot>& someNavData);
+	bool ExportNavData(const NavDataSnapshot& aNavData, metronome::NavTilePool* aPool) const; //aPool is null when there is only one agent
+	static bool ExportNavTiles(const dtNavMesh& aNavMesh, const std::string& aOutPath);
+	static dtNavMesh* CopyNavMesh(const dtNavMesh& aNavMesh);
+	static std::uint64_t HashNavTile(const dtMeshTile& aTile, ENavExportMode aMode, float aSimplifyTolerance);
+	static std::vector<metronome::NavAreaCost> GetAreaCosts(const ARecastNavMesh& aNavData);
+	static void GatherNavTileGraph(const dtNavMesh& aNavMesh, const dtMeshTile& aTile, metronome::NavTileGraph& aGraph);
+	static void GatherNavTilePolygons(const dtMeshTile& aTile, float aSimplifyTolerance, metronome::NavMeshBuilder& aBuilder);
+	static void GatherNavTileDetailMesh(const dtMeshTile& aTile, metronome::NavMeshBuilder& aBuilder);
+
+	void SnapshotScene(metronome::SceneSnapshot& aSnapshot);
+	bool WriteSceneFile(const std::string& aOutPath, const metronome::SceneSnapshot& aSnapshot) const;
+	void SnapshotEntity(metronome::SceneSnapshot& aSnapshot, const AActor& aActor, std::int32_t aParent);
+	void SnapshotFolderEntity(metronome::SceneSnapshot& aSnapshot, const std::string& aName, const Folder& aFolder, std::int32_t aParent);
+	void SnapshotComponents(metronome::SceneSnapshot& aSnapshot, const AActor& aActor, std::uint32_t anEntity);
 
 	template<typename T>
 	static void ForeachComponent(const AActor& aActor, const std::function<void(T&)>& aFunc);
@@ -73,22 +139,17 @@ private:
 	void EnsureMaterial(const FString& aPath);
 	void EnsureFolder(const FString& aPath);
 
-	nlohmann::json CreateNameTagJson(const std::string& aName);
-	nlohmann::json CreateParentJson(const TArray<AActor*>& someChildren);
-	nlohmann::json CreateTransformJson(const FTransform& aSrc);
-	nlohmann::json CreateLightJson(const ULightComponent& aSrc);
-	nlohmann::json CreatePointLightJson(const UPointLightComponent& aSrc);
-	nlohmann::json CreateSpotLightJson(const USpotLightComponent& aSrc);
-	nlohmann::json CreateDirectionalLightJson(const UDirectionalLightComponent& aSrc);
-
-	nlohmann::json CreateFVectorJson(const FVector& aSrc);
-	nlohmann::json CreateFQuatJson(const FQuat& aSrc);
-	nlohmann::json CreateColorJson(const FLinearColor& aSrc);
-
-	static FVector ToExportFVector(const FVector& aSrc);
-	static FQuat ToExportFQuat(const FQuat& aSrc);
+	static metronome::Vec3 ToVec3(const FVector& aSrc);
+	static metronome::Quat ToQuat(const FQuat& aSrc);
+	static metronome::Color ToColor(const FLinearColor& aSrc);
+	static metronome::Transform ToTransform(const FTransform& aSrc);
+	static void ToLight(const ULightComponent& aSrc, metronome::Light& aResult);
+	static metronome::PointLight ToPointLight(const UPointLightComponent& aSrc);
+	static metronome::SpotLight ToSpotLight(const USpotLightComponent& aSrc);
+	static metronome::DirectionalLight ToDirectionalLight(const UDirectionalLightComponent& aSrc);
 
 	ExportContext context;
+	TFuture<void> exportTask;
 };
 
 template <typename T>